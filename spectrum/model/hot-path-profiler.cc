@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "hot-path-profiler.h"
+#include <ns3/simulator.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <vector>
+
+namespace ns3 {
+
+namespace {
+
+/**
+ * \return the registered sites; a list, so that sites never move
+ */
+std::list<HotPathProfiler::Site> &
+GetSites (void)
+{
+  static std::list<HotPathProfiler::Site> sites;
+  return sites;
+}
+
+/**
+ * \param a a site
+ * \param b another site
+ * \return true if <i>a</i> took more time than <i>b</i>
+ */
+bool
+TookLonger (const HotPathProfiler::Site *a, const HotPathProfiler::Site *b)
+{
+  return a->ns > b->ns;
+}
+
+} //anonymous namespace
+
+bool HotPathProfiler::m_printScheduled = false;
+
+HotPathProfiler::Site *
+HotPathProfiler::Register (const char *name)
+{
+  Site site;
+  site.name = name;
+  site.calls = 0;
+  site.ns = 0;
+  GetSites ().push_back (site);
+  return &GetSites ().back ();
+}
+
+void
+HotPathProfiler::Print (std::ostream &os)
+{
+  std::vector<const Site *> sites;
+  for (std::list<Site>::const_iterator i = GetSites ().begin (); i != GetSites ().end (); i++)
+    {
+      if (i->calls > 0)
+        {
+          sites.push_back (&*i);
+        }
+    }
+  std::sort (sites.begin (), sites.end (), TookLonger);
+  std::ios_base::fmtflags flags = os.flags ();
+  std::streamsize precision = os.precision ();
+  os << std::left << std::setw (48) << "site"
+     << std::right << std::setw (12) << "calls"
+     << std::setw (14) << "total (ms)"
+     << std::setw (12) << "ns/call" << std::endl;
+  for (std::vector<const Site *>::const_iterator i = sites.begin (); i != sites.end (); i++)
+    {
+      os << std::left << std::setw (48) << (*i)->name
+         << std::right << std::setw (12) << (*i)->calls
+         << std::setw (14) << std::fixed << std::setprecision (3) << (*i)->ns / 1e6
+         << std::setw (12) << (*i)->ns / (*i)->calls << std::endl;
+    }
+  os.flags (flags);
+  os.precision (precision);
+}
+
+void
+HotPathProfiler::Reset (void)
+{
+  for (std::list<Site>::iterator i = GetSites ().begin (); i != GetSites ().end (); i++)
+    {
+      i->calls = 0;
+      i->ns = 0;
+    }
+}
+
+void
+HotPathProfiler::SchedulePrint (void)
+{
+  m_printScheduled = true;
+  Simulator::ScheduleDestroy (&HotPathProfiler::PrintAndReset);
+}
+
+void
+HotPathProfiler::PrintAndReset (void)
+{
+  Print (std::clog);
+  Reset ();
+  m_printScheduled = false;
+}
+
+} //namespace ns3
@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef HOT_PATH_PROFILER_H
+#define HOT_PATH_PROFILER_H
+
+#include <stdint.h>
+#include <chrono>
+#include <ostream>
+
+/**
+ * \file
+ * \ingroup spectrum
+ * Scoped timers around the hot functions of the channel, PHY and MAC.
+ *
+ * The timers are compiled in only when NS3_PROFILING_ENABLE is defined,
+ * i.e., when ns-3 is configured with --enable-profiling-hooks. Otherwise
+ * NS_PROFILE_FUNCTION expands to nothing.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup spectrum
+ * \brief Call counts and cumulative wall-clock time of profiled functions
+ *
+ * Every function instrumented with NS_PROFILE_FUNCTION registers a site
+ * the first time it runs. Each call then adds its wall-clock duration,
+ * measured with std::chrono::steady_clock, to its site. Durations are
+ * inclusive: the time of a profiled function called by another profiled
+ * function is counted by both.
+ *
+ * The first call after the start of a simulation schedules the printing
+ * of the table of the sites to std::clog at Simulator::Destroy, after
+ * which the sites are reset.
+ */
+class HotPathProfiler
+{
+public:
+  /// call count and cumulative duration of a profiled function
+  struct Site
+  {
+    const char *name;  //!< name of the function
+    uint64_t calls;    //!< number of calls
+    uint64_t ns;       //!< cumulative duration of the calls, in nanoseconds
+  };
+
+  /**
+   * \param name the name of the function, which must outlive the simulation
+   * \return the site of the function, valid until the end of the program
+   */
+  static Site * Register (const char *name);
+  /**
+   * Add a call to a site.
+   *
+   * \param site the site
+   * \param ns the duration of the call, in nanoseconds
+   */
+  static void NotifyCall (Site *site, uint64_t ns)
+  {
+    site->calls++;
+    site->ns += ns;
+    if (!m_printScheduled)
+      {
+        SchedulePrint ();
+      }
+  }
+  /**
+   * Print the sites called at least once, by decreasing cumulative duration.
+   *
+   * \param os the output stream
+   */
+  static void Print (std::ostream &os);
+  /**
+   * Clear the call counts and durations of all the sites.
+   */
+  static void Reset (void);
+
+
+private:
+  /**
+   * Print the table to std::clog at Simulator::Destroy.
+   */
+  static void SchedulePrint (void);
+  /**
+   * Print the table to std::clog and reset the sites.
+   */
+  static void PrintAndReset (void);
+
+  static bool m_printScheduled; //!< whether the table is printed at the next Simulator::Destroy
+};
+
+/**
+ * \ingroup spectrum
+ * \brief Add the duration of its scope to a profiler site
+ */
+class HotPathTimer
+{
+public:
+  /**
+   * \param site the site to which the duration of the scope is added
+   */
+  HotPathTimer (HotPathProfiler::Site *site)
+    : m_site (site),
+      m_start (std::chrono::steady_clock::now ())
+  {
+  }
+  ~HotPathTimer ()
+  {
+    std::chrono::steady_clock::duration d = std::chrono::steady_clock::now () - m_start;
+    HotPathProfiler::NotifyCall (m_site, std::chrono::duration_cast<std::chrono::nanoseconds> (d).count ());
+  }
+
+
+private:
+  HotPathProfiler::Site *m_site;                     //!< the site
+  std::chrono::steady_clock::time_point m_start;     //!< start of the scope
+};
+
+} //namespace ns3
+
+#ifdef NS3_PROFILING_ENABLE
+/**
+ * \ingroup spectrum
+ * Add the duration of the enclosing scope to the profiler site <i>name</i>.
+ *
+ * \param name the name of the site, a string literal
+ */
+#define NS_PROFILE_FUNCTION(name)                                       \
+  static ns3::HotPathProfiler::Site *ns3ProfilerSite = ns3::HotPathProfiler::Register (name); \
+  ns3::HotPathTimer ns3ProfilerTimer (ns3ProfilerSite)
+#else
+#define NS_PROFILE_FUNCTION(name)
+#endif
+
+#endif /* HOT_PATH_PROFILER_H */
@@ -37,6 +37,7 @@
 #include <iostream>
 #include <utility>
 #include "multi-model-spectrum-channel.h"
+#include "hot-path-profiler.h"
 
 
 namespace ns3 {
@@ -258,6 +259,7 @@ void
 MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 {
   NS_LOG_FUNCTION (this << txParams);
+  NS_PROFILE_FUNCTION ("MultiModelSpectrumChannel::StartTx");
 
   NS_ASSERT (txParams->txPhy);
   NS_ASSERT (txParams->psd);
@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MICROBENCHMARK_H
+#define MICROBENCHMARK_H
+
+#include <stdint.h>
+#include <chrono>
+#include <ostream>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \ingroup spectrum
+ * \brief Minimal wall-clock microbenchmark runner
+ *
+ * Run calls a function in batches of doubling size until a batch lasts at
+ * least the minimum time, and prints one CSV line "name,iterations,nsPerOp"
+ * for the last batch. Benchmarks whose name does not contain the filter
+ * are skipped.
+ *
+ * The functions should pass their results to DoNotOptimize, so that the
+ * compiler cannot drop the calls being measured.
+ */
+class Microbenchmark
+{
+public:
+  /**
+   * \param os the output stream
+   * \param minSeconds the minimum duration of the measured batch
+   * \param filter the substring of the names of the benchmarks to run
+   */
+  Microbenchmark (std::ostream &os, double minSeconds, std::string filter)
+    : m_os (os),
+      m_minSeconds (minSeconds),
+      m_filter (filter)
+  {
+  }
+
+  /**
+   * Print the CSV header.
+   */
+  void PrintHeader (void)
+  {
+    m_os << "benchmark,iterations,nsPerOp" << std::endl;
+  }
+
+  /**
+   * \param name the name of the benchmark
+   * \param f the function to measure, called without argument
+   */
+  template <typename F>
+  void Run (std::string name, F f)
+  {
+    if (name.find (m_filter) == std::string::npos)
+      {
+        return;
+      }
+    uint64_t iterations = 1;
+    double seconds = 0;
+    while (true)
+      {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+        for (uint64_t i = 0; i < iterations; i++)
+          {
+            f ();
+          }
+        seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+        if (seconds >= m_minSeconds)
+          {
+            break;
+          }
+        iterations *= 2;
+      }
+    m_os << name << "," << iterations << "," << seconds * 1e9 / iterations << std::endl;
+  }
+
+  /**
+   * \param value a result of the function measured
+   */
+  static void DoNotOptimize (double value)
+  {
+    static volatile double sink;
+    sink = value;
+    (void) sink;
+  }
+
+
+private:
+  std::ostream &m_os;   //!< the output stream
+  double m_minSeconds;  //!< the minimum duration of the measured batch
+  std::string m_filter; //!< the substring of the names of the benchmarks to run
+};
+
+} //namespace ns3
+
+#endif /* MICROBENCHMARK_H */
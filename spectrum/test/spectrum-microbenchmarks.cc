@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Microbenchmarks of the spectrum primitives called for every signal
+// sent on a spectrum channel: SpectrumValue arithmetic and integration,
+// SpectrumConverter::Convert, and the creation of the wifi transmit PSDs
+// and RF filters, over the spectrum model of a 20 MHz 802.11ax channel.
+//
+// One CSV line is printed per benchmark: its name, the number of
+// iterations of the measured batch and the wall-clock time per iteration.
+
+#include <ns3/command-line.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/spectrum-converter.h>
+#include <ns3/wifi-spectrum-value-helper.h>
+#include <ns3/microbenchmark.h>
+#include <iostream>
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  double minTime = 0.2; //seconds
+  std::string filter = "";
+
+  CommandLine cmd;
+  cmd.AddValue ("minTime", "Minimum duration of the measured batch of each benchmark in seconds", minTime);
+  cmd.AddValue ("filter", "Only run the benchmarks whose name contains this string", filter);
+  cmd.Parse (argc, argv);
+
+  const uint32_t frequency = 5180;
+  const uint8_t channelWidth = 20;
+  const double bandBandwidth = 78125;
+  const uint8_t guardBandwidth = 10; //as SpectrumWifiPhy
+
+  Ptr<SpectrumModel> model = WifiSpectrumValueHelper::GetSpectrumModel (frequency, channelWidth, bandBandwidth, guardBandwidth);
+  Ptr<SpectrumModel> model40 = WifiSpectrumValueHelper::GetSpectrumModel (frequency + 10, 40, bandBandwidth, guardBandwidth);
+  Ptr<SpectrumValue> psd = WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (frequency, channelWidth, 0.1, guardBandwidth, 9, false);
+  Ptr<SpectrumValue> filterPsd = WifiSpectrumValueHelper::CreateRfFilter (frequency, channelWidth, bandBandwidth, guardBandwidth);
+  SpectrumValue a = *psd;
+  SpectrumValue b = *filterPsd;
+  SpectrumConverter converter (model, model40);
+
+  Microbenchmark bench (std::cout, minTime, filter);
+  bench.PrintHeader ();
+
+  bench.Run ("SpectrumValue/add", [&] () {
+    SpectrumValue c = a + b;
+    Microbenchmark::DoNotOptimize (c[0]);
+  });
+  bench.Run ("SpectrumValue/multiply", [&] () {
+    SpectrumValue c = a * b;
+    Microbenchmark::DoNotOptimize (c[0]);
+  });
+  bench.Run ("SpectrumValue/multiplyAssign", [&] () {
+    SpectrumValue c = a;
+    c *= b;
+    Microbenchmark::DoNotOptimize (c[0]);
+  });
+  bench.Run ("SpectrumValue/Sum", [&] () {
+    Microbenchmark::DoNotOptimize (Sum (a));
+  });
+  bench.Run ("SpectrumValue/Integral", [&] () {
+    Microbenchmark::DoNotOptimize (Integral (a));
+  });
+  bench.Run ("SpectrumValue/rxPower", [&] () {
+    //the received power of a signal through an RF filter, as SpectrumWifiPhy computes it
+    Microbenchmark::DoNotOptimize (Integral (a * b));
+  });
+  bench.Run ("SpectrumConverter/Convert20To40", [&] () {
+    Microbenchmark::DoNotOptimize ((*converter.Convert (psd))[0]);
+  });
+  bench.Run ("WifiSpectrumValueHelper/CreateHeOfdmTxPowerSpectralDensity", [&] () {
+    Ptr<SpectrumValue> v = WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (frequency, channelWidth, 0.1, guardBandwidth, 9, false);
+    Microbenchmark::DoNotOptimize ((*v)[0]);
+  });
+  bench.Run ("WifiSpectrumValueHelper/CreateHeOfdmTxPowerSpectralDensityRu", [&] () {
+    Ptr<SpectrumValue> v = WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (frequency, channelWidth, 0.1, guardBandwidth, 4, true);
+    Microbenchmark::DoNotOptimize ((*v)[0]);
+  });
+  bench.Run ("WifiSpectrumValueHelper/CreateRfFilter", [&] () {
+    Ptr<SpectrumValue> v = WifiSpectrumValueHelper::CreateRfFilter (frequency, channelWidth, bandBandwidth, guardBandwidth);
+    Microbenchmark::DoNotOptimize ((*v)[0]);
+  });
+  bench.Run ("WifiSpectrumValueHelper/CreateRfFilterRu", [&] () {
+    Ptr<SpectrumValue> v = WifiSpectrumValueHelper::CreateRfFilter (frequency, channelWidth, bandBandwidth, guardBandwidth, 4);
+    Microbenchmark::DoNotOptimize ((*v)[0]);
+  });
+
+  return 0;
+}
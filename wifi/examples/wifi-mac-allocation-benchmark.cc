@@ -0,0 +1,238 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure the heap allocations per delivered MPDU in a saturated 802.11ax
+// uplink (or downlink) scenario, without and with the WifiMacQueueItem
+// pool.
+//
+// One AP and --noNodes STAs share a 20 MHz spectrum channel; every STA (or
+// the AP, for each STA) hands a packet to the MAC every --interval seconds.
+// The scenario is simulated twice, each time in a child process, first
+// with the item pool disabled and then with it enabled. The global
+// operator new of this program counts every heap allocation made during
+// Simulator::Run.
+//
+// The results are written as CSV to --output, one line per simulation
+// after a header line (the MACs print their own traces to the standard
+// output):
+//  - pool: whether the item pool was enabled;
+//  - deliveredMpdus: MPDUs delivered to the upper layer;
+//  - itemsCreated: WifiMacQueueItem created;
+//  - itemHeapAllocations: heap allocations made to create the items;
+//  - heapAllocations: all the heap allocations made during the run;
+//  - heapAllocationsPerMpdu and itemHeapAllocationsPerMpdu: the same, per
+//    delivered MPDU.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/spectrum-module.h"
+#include "ns3/propagation-module.h"
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("WifiMacAllocationBenchmark");
+
+uint64_t g_heapAllocations = 0; ///< number of calls to the global operator new
+uint64_t g_rxMpdus = 0; ///< number of MPDUs delivered to the upper layer
+
+/**
+ * Count the allocations of the whole program, including the ns-3 libraries.
+ *
+ * \param size the size of the allocation
+ * \return the allocated memory
+ */
+void *
+operator new (std::size_t size)
+{
+  g_heapAllocations++;
+  void *p = std::malloc (size == 0 ? 1 : size);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+/**
+ * \param p the memory to free
+ */
+void
+operator delete (void *p) throw ()
+{
+  std::free (p);
+}
+
+/**
+ * \param p the memory to free
+ */
+void
+operator delete (void *p, std::size_t) throw ()
+{
+  std::free (p);
+}
+
+void
+MacRx (std::string context, Ptr<const Packet> packet)
+{
+  g_rxMpdus++;
+}
+
+void
+SendOnePacket (Ptr<WifiNetDevice> sender, Ptr<WifiNetDevice> receiver, uint32_t size)
+{
+  sender->Send (Create<Packet> (size), receiver->GetAddress (), 1);
+}
+
+void
+RunOne (bool pool, uint32_t noNodes, double simulationTime, double interval,
+        uint32_t packetSize, bool uplink, std::string output)
+{
+  WifiMacQueueItem::SetPoolEnabled (pool);
+
+  NodeContainer apNode;
+  apNode.Create (1);
+  NodeContainer staNodes;
+  staNodes.Create (noNodes);
+
+  Ptr<MultiModelSpectrumChannel> spectrumChannel = CreateObject<MultiModelSpectrumChannel> ();
+  spectrumChannel->AddPropagationLossModel (CreateObject<FriisPropagationLossModel> ());
+  spectrumChannel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+
+  SpectrumWifiPhyHelper phy = SpectrumWifiPhyHelper::Default ();
+  phy.SetChannel (spectrumChannel);
+  phy.Set ("Frequency", UintegerValue (5180));
+  phy.Set ("ChannelWidth", UintegerValue (20));
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ax_5GHZ);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate6Mbps"),
+                                "ControlMode", StringValue ("OfdmRate6Mbps"));
+
+  WifiMacHelper mac;
+  Ssid ssid = Ssid ("benchmark");
+  mac.SetType ("ns3::ApWifiMac", "Ssid", SsidValue (ssid));
+  NetDeviceContainer apDevice = wifi.Install (phy, mac, apNode);
+  mac.SetType ("ns3::StaWifiMac", "Ssid", SsidValue (ssid), "ActiveProbing", BooleanValue (false));
+  NetDeviceContainer staDevices = wifi.Install (phy, mac, staNodes);
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  for (uint32_t i = 0; i < noNodes; i++)
+    {
+      positionAlloc->Add (Vector (cos (2 * M_PI * i / noNodes), sin (2 * M_PI * i / noNodes), 0.0));
+    }
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (apNode);
+  mobility.Install (staNodes);
+
+  Ptr<WifiNetDevice> ap = DynamicCast<WifiNetDevice> (apDevice.Get (0));
+  for (uint32_t i = 0; i < noNodes; i++)
+    {
+      Ptr<WifiNetDevice> sta = DynamicCast<WifiNetDevice> (staDevices.Get (i));
+      for (double t = 1.0; t < simulationTime; t += interval)
+        {
+          if (uplink)
+            {
+              Simulator::Schedule (Seconds (t), &SendOnePacket, sta, ap, packetSize);
+            }
+          else
+            {
+              Simulator::Schedule (Seconds (t), &SendOnePacket, ap, sta, packetSize);
+            }
+        }
+    }
+
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/MacRx", MakeCallback (&MacRx));
+
+  uint64_t itemsBefore = WifiMacQueueItem::GetNAllocations ();
+  uint64_t itemHeapBefore = WifiMacQueueItem::GetNHeapAllocations ();
+  uint64_t heapBefore = g_heapAllocations;
+
+  Simulator::Stop (Seconds (simulationTime));
+  Simulator::Run ();
+
+  uint64_t heap = g_heapAllocations - heapBefore;
+  uint64_t items = WifiMacQueueItem::GetNAllocations () - itemsBefore;
+  uint64_t itemHeap = WifiMacQueueItem::GetNHeapAllocations () - itemHeapBefore;
+  Simulator::Destroy ();
+
+  std::ofstream os (output.c_str (), std::ios::app);
+  os << pool << ","
+     << g_rxMpdus << ","
+     << items << ","
+     << itemHeap << ","
+     << heap << ","
+     << (g_rxMpdus > 0 ? static_cast<double> (heap) / g_rxMpdus : 0) << ","
+     << (g_rxMpdus > 0 ? static_cast<double> (itemHeap) / g_rxMpdus : 0)
+     << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t noNodes = 9;
+  double simulationTime = 5.0; //seconds
+  double interval = 0.001; //seconds
+  uint32_t packetSize = 1000; //bytes
+  bool uplink = true;
+  std::string output = "wifi-mac-allocation-benchmark.csv";
+
+  CommandLine cmd;
+  cmd.AddValue ("noNodes", "Number of STAs", noNodes);
+  cmd.AddValue ("simulationTime", "Simulation time in seconds", simulationTime);
+  cmd.AddValue ("interval", "Inter-packet interval per STA in seconds", interval);
+  cmd.AddValue ("packetSize", "Size of the packets in bytes", packetSize);
+  cmd.AddValue ("uplink", "Uplink traffic if true, downlink traffic otherwise", uplink);
+  cmd.AddValue ("output", "Name of the CSV file of the results", output);
+  cmd.Parse (argc, argv);
+
+  {
+    std::ofstream os (output.c_str (), std::ios::trunc);
+    os << "pool,deliveredMpdus,itemsCreated,itemHeapAllocations,heapAllocations,"
+       << "heapAllocationsPerMpdu,itemHeapAllocationsPerMpdu" << std::endl;
+  }
+
+  for (uint32_t pool = 0; pool <= 1; pool++)
+    {
+      pid_t pid = fork ();
+      NS_ABORT_MSG_IF (pid < 0, "fork failed");
+      if (pid == 0)
+        {
+          RunOne (pool == 1, noNodes, simulationTime, interval, packetSize, uplink, output);
+          std::cout.flush ();
+          _exit (0);
+        }
+      int status;
+      waitpid (pid, &status, 0);
+      if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+        {
+          std::cerr << "Simulation with pool=" << pool << " failed" << std::endl;
+        }
+    }
+
+  return 0;
+}
+
@@ -0,0 +1,289 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure how the simulator scales with the number of STAs in a saturated
+// 802.11ax uplink OFDMA scenario.
+//
+// The scenario is the one of test.cc: one AP and --noNodes STAs on a
+// circle of 1 m around it share a 20 MHz spectrum channel, the AP
+// schedules the STAs on the RUs with trigger frames, and every STA hands a
+// packet to the MAC every --interval seconds from t = 1 s on.
+//
+// --noNodes, --nScheduled, --maxTfSlots and --tfCw take comma-separated
+// lists, and one simulation is run for every combination of their values.
+// Each simulation runs in a child process: the OFDMA MACs keep static
+// state that does not survive Simulator::Destroy, and the peak RSS of the
+// child is the one of that simulation only.
+//
+// The results are written as CSV to --output, one line per simulation
+// after a header line (the MACs print their own traces to the standard
+// output):
+//  - wallClockS: wall-clock time of Simulator::Run, in seconds;
+//  - events: number of events executed;
+//  - eventsPerS: events executed per wall-clock second;
+//  - peakRssKb: peak resident set size of the simulation, in kB;
+//  - throughputMbps: payload received by the AP from t = 1 s on.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/spectrum-module.h"
+#include "ns3/propagation-module.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("WifiOfdmaScalingBenchmark");
+
+/// parameters of a simulation
+struct BenchmarkPoint
+{
+  uint32_t noNodes;    ///< number of STAs
+  uint32_t nScheduled; ///< number of STAs scheduled per TF
+  uint32_t maxTfSlots; ///< maximum number of TF slots for BSR expiry
+  uint32_t tfCw;       ///< TF contention window
+};
+
+uint64_t g_rxBytes = 0; ///< payload bytes received by the AP
+
+bool
+Receive (Ptr<NetDevice> dev, Ptr<const Packet> packet, uint16_t mode, const Address &sender)
+{
+  if (Simulator::Now () >= Seconds (1.0))
+    {
+      g_rxBytes += packet->GetSize ();
+    }
+  return true;
+}
+
+void
+SendPackets (Ptr<WifiNetDevice> sta, Address ap, uint32_t size, Time interval, Time stop)
+{
+  sta->Send (Create<Packet> (size), ap, 1);
+  if (Simulator::Now () + interval < stop)
+    {
+      Simulator::Schedule (interval, &SendPackets, sta, ap, size, interval, stop);
+    }
+}
+
+std::vector<uint32_t>
+ParseList (std::string list)
+{
+  std::vector<uint32_t> values;
+  std::istringstream iss (list);
+  std::string value;
+  while (std::getline (iss, value, ','))
+    {
+      values.push_back (std::atoi (value.c_str ()));
+    }
+  if (values.empty ())
+    {
+      NS_FATAL_ERROR ("Empty list of values: \"" << list << "\"");
+    }
+  return values;
+}
+
+void
+RunPoint (BenchmarkPoint point, double simulationTime, double interval, uint32_t packetSize,
+          uint32_t tfDuration, uint32_t tfCwMin, uint32_t tfCwMax, bool sharedContention,
+          std::string output)
+{
+  NodeContainer staNodes;
+  staNodes.Create (point.noNodes);
+  NodeContainer apNode;
+  apNode.Create (1);
+
+  Ptr<MultiModelSpectrumChannel> spectrumChannel = CreateObject<MultiModelSpectrumChannel> ();
+  spectrumChannel->AddPropagationLossModel (CreateObject<FriisPropagationLossModel> ());
+  spectrumChannel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  if (sharedContention)
+    {
+      spectrumChannel->AggregateObject (CreateObject<SharedMediumContention> ());
+    }
+
+  SpectrumWifiPhyHelper phy = SpectrumWifiPhyHelper::Default ();
+  phy.SetChannel (spectrumChannel);
+  phy.SetErrorRateModel ("ns3::NistErrorRateModel");
+  phy.Set ("Frequency", UintegerValue (5180));
+  phy.Set ("ShortGuardEnabled", BooleanValue (false));
+  phy.Set ("ChannelWidth", UintegerValue (20));
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211ax_5GHZ);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate6Mbps"),
+                                "ControlMode", StringValue ("OfdmRate6Mbps"));
+
+  WifiMacHelper mac;
+  Ssid ssid = Ssid ("benchmark");
+  mac.SetType ("ns3::ApWifiMac", "Ssid", SsidValue (ssid),
+               "TfDuration", UintegerValue (tfDuration),
+               "MaxTfSlots", UintegerValue (point.maxTfSlots),
+               "TfCw", UintegerValue (point.tfCw),
+               "TfCwMax", UintegerValue (tfCwMax),
+               "TfCwMin", UintegerValue (tfCwMin),
+               "Alpha", DoubleValue (0),
+               "nScheduled", UintegerValue (point.nScheduled));
+  NetDeviceContainer apDevice = wifi.Install (phy, mac, apNode);
+  mac.SetType ("ns3::StaWifiMac", "Ssid", SsidValue (ssid),
+               "ActiveProbing", BooleanValue (false),
+               "MaxTfSlots", UintegerValue (point.maxTfSlots),
+               "TfCw", UintegerValue (point.tfCw),
+               "TfCwMax", UintegerValue (tfCwMax),
+               "TfCwMin", UintegerValue (tfCwMin),
+               "Alpha", DoubleValue (0),
+               "nScheduled", UintegerValue (point.nScheduled));
+  NetDeviceContainer staDevices = wifi.Install (phy, mac, staNodes);
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  for (uint32_t i = 0; i < point.noNodes; i++)
+    {
+      positionAlloc->Add (Vector (cos (2 * M_PI * i / point.noNodes), sin (2 * M_PI * i / point.noNodes), 0.0));
+    }
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (apNode);
+  mobility.Install (staNodes);
+
+  Ptr<WifiNetDevice> ap = DynamicCast<WifiNetDevice> (apDevice.Get (0));
+  ap->SetReceiveCallback (MakeCallback (&Receive));
+  for (uint32_t i = 0; i < point.noNodes; i++)
+    {
+      Ptr<WifiNetDevice> sta = DynamicCast<WifiNetDevice> (staDevices.Get (i));
+      Simulator::Schedule (Seconds (1.0), &SendPackets, sta, ap->GetAddress (), packetSize,
+                           Seconds (interval), Seconds (simulationTime));
+    }
+
+  Simulator::Stop (Seconds (simulationTime));
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  Simulator::Run ();
+  double wallClock = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+  uint64_t events = Simulator::GetEventCount ();
+  Simulator::Destroy ();
+
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+
+  std::ofstream os (output.c_str (), std::ios::app);
+  os << point.noNodes << ","
+     << point.nScheduled << ","
+     << point.maxTfSlots << ","
+     << point.tfCw << ","
+     << simulationTime << ","
+     << wallClock << ","
+     << events << ","
+     << (wallClock > 0 ? events / wallClock : 0) << ","
+     << usage.ru_maxrss << ","
+     << g_rxBytes * 8 / (1e6 * (simulationTime - 1.0))
+     << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string noNodesList = "10,50,100,200,500";
+  std::string nScheduledList = "8";
+  std::string maxTfSlotsList = "16";
+  std::string tfCwList = "32";
+  double simulationTime = 2.0; //seconds
+  double interval = 0.001; //seconds
+  uint32_t packetSize = 1035; //bytes, the size of the packets of test.cc
+  uint32_t tfDuration = 168;
+  uint32_t tfCwMin = 32;
+  uint32_t tfCwMax = 1024;
+  bool sharedContention = false;
+  uint32_t seed = 1;
+  uint32_t run = 11;
+  std::string output = "wifi-ofdma-scaling-benchmark.csv";
+
+  CommandLine cmd;
+  cmd.AddValue ("noNodes", "Comma-separated numbers of STAs", noNodesList);
+  cmd.AddValue ("nScheduled", "Comma-separated numbers of STAs scheduled per TF", nScheduledList);
+  cmd.AddValue ("maxTfSlots", "Comma-separated maximum time slots for BSR expiry", maxTfSlotsList);
+  cmd.AddValue ("tfCw", "Comma-separated TF contention windows", tfCwList);
+  cmd.AddValue ("simulationTime", "Simulation time in seconds, traffic starts at 1 s", simulationTime);
+  cmd.AddValue ("interval", "Inter-packet interval per STA in seconds", interval);
+  cmd.AddValue ("packetSize", "Size of the packets in bytes", packetSize);
+  cmd.AddValue ("tfDuration", "TF duration in units of slot time", tfDuration);
+  cmd.AddValue ("tfCwMin", "Minimum TF contention window", tfCwMin);
+  cmd.AddValue ("tfCwMax", "Maximum TF contention window", tfCwMax);
+  cmd.AddValue ("sharedContention", "Aggregate a SharedMediumContention to the channel", sharedContention);
+  cmd.AddValue ("seed", "Seed of the random number generators", seed);
+  cmd.AddValue ("run", "Run number of the random number generators", run);
+  cmd.AddValue ("output", "Name of the CSV file of the results", output);
+  cmd.Parse (argc, argv);
+
+  NS_ABORT_MSG_IF (simulationTime <= 1.0, "The simulation must last more than 1 s");
+
+  std::vector<uint32_t> noNodes = ParseList (noNodesList);
+  std::vector<uint32_t> nScheduled = ParseList (nScheduledList);
+  std::vector<uint32_t> maxTfSlots = ParseList (maxTfSlotsList);
+  std::vector<uint32_t> tfCw = ParseList (tfCwList);
+
+  {
+    std::ofstream os (output.c_str (), std::ios::trunc);
+    os << "noNodes,nScheduled,maxTfSlots,tfCw,simulationTime,"
+       << "wallClockS,events,eventsPerS,peakRssKb,throughputMbps" << std::endl;
+  }
+
+  for (std::vector<uint32_t>::const_iterator n = noNodes.begin (); n != noNodes.end (); n++)
+    {
+      for (std::vector<uint32_t>::const_iterator s = nScheduled.begin (); s != nScheduled.end (); s++)
+        {
+          for (std::vector<uint32_t>::const_iterator m = maxTfSlots.begin (); m != maxTfSlots.end (); m++)
+            {
+              for (std::vector<uint32_t>::const_iterator c = tfCw.begin (); c != tfCw.end (); c++)
+                {
+                  BenchmarkPoint point;
+                  point.noNodes = *n;
+                  point.nScheduled = *s;
+                  point.maxTfSlots = *m;
+                  point.tfCw = *c;
+                  pid_t pid = fork ();
+                  NS_ABORT_MSG_IF (pid < 0, "fork failed");
+                  if (pid == 0)
+                    {
+                      RngSeedManager::SetSeed (seed);
+                      RngSeedManager::SetRun (run);
+                      RunPoint (point, simulationTime, interval, packetSize,
+                                tfDuration, tfCwMin, tfCwMax, sharedContention, output);
+                      std::cout.flush ();
+                      _exit (0);
+                    }
+                  int status;
+                  waitpid (pid, &status, 0);
+                  if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+                    {
+                      std::cerr << "Simulation with noNodes=" << *n << " nScheduled=" << *s
+                                << " maxTfSlots=" << *m << " tfCw=" << *c << " failed" << std::endl;
+                    }
+                }
+            }
+        }
+    }
+
+  return 0;
+}
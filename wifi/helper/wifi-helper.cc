@@ -23,6 +23,7 @@
 #include "wifi-helper.h"
 #include "ns3/wifi-net-device.h"
 #include "ns3/minstrel-wifi-manager.h"
+#include "ns3/he-ru-wifi-manager.h"
 #include "ns3/ap-wifi-mac.h"
 #include "ns3/ampdu-subframe-header.h"
 #include "ns3/log.h"
@@ -780,6 +781,12 @@ WifiHelper::Install (const WifiPhyHelper &phyHelper,
                phyMu->SetRuBits (j);
 	       device->SetMuPhy (phyMu, j);              
                device->SetMuRemoteStationManager (managerMu, j);
+               Ptr<HeRuWifiManager> heManager = DynamicCast<HeRuWifiManager> (manager);
+               if (heManager != 0)
+                 {
+                   // infocom: one station estimate for the channel and all the RUs
+                   DynamicCast<HeRuWifiManager> (managerMu)->ShareEstimates (heManager);
+                 }
             }      
        }
       node->AddDevice (device);
@@ -830,6 +837,7 @@ WifiHelper::EnableLogComponents (void)
   LogComponentEnable ("DcfManager", LOG_LEVEL_ALL);
   LogComponentEnable ("DsssErrorRateModel", LOG_LEVEL_ALL);
   LogComponentEnable ("EdcaTxopN", LOG_LEVEL_ALL);
+  LogComponentEnable ("HeRuWifiManager", LOG_LEVEL_ALL);
   LogComponentEnable ("IdealWifiManager", LOG_LEVEL_ALL);
   LogComponentEnable ("InterferenceHelper", LOG_LEVEL_ALL);
   LogComponentEnable ("MacLow", LOG_LEVEL_ALL);
@@ -863,6 +871,57 @@ WifiHelper::EnableLogComponents (void)
   LogComponentEnable ("YansWifiPhy", LOG_LEVEL_ALL);
 }
 
+void
+WifiHelper::PrintStateTimes (NetDeviceContainer c, std::ostream &os)
+{
+  for (NetDeviceContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<WifiNetDevice> wifi = DynamicCast<WifiNetDevice> (*i);
+      if (wifi == 0)
+        {
+          continue;
+        }
+      //infocom: index -1 is the PHY of the full channel, then the RUs
+      for (int32_t ru = -1; ru < 9; ru++)
+        {
+          Ptr<WifiPhy> phy = (ru < 0) ? wifi->GetPhy () : wifi->GetMuPhy (ru);
+          if (phy == 0)
+            {
+              continue;
+            }
+          os << "node " << wifi->GetNode ()->GetId () << " device " << wifi->GetIfIndex ();
+          if (ru < 0)
+            {
+              os << " phy";
+            }
+          else
+            {
+              os << " ru " << ru;
+            }
+          for (uint32_t state = WifiPhy::IDLE; state <= WifiPhy::SLEEP; state++)
+            {
+              os << " " << phy->GetCumulativeStateTime ((WifiPhy::State) state).GetSeconds ();
+            }
+          os << std::endl;
+        }
+    }
+}
+
+std::vector<WifiDeviceCounters>
+WifiHelper::GetCounters (NetDeviceContainer c)
+{
+  std::vector<WifiDeviceCounters> counters;
+  for (NetDeviceContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<WifiNetDevice> wifi = DynamicCast<WifiNetDevice> (*i);
+      if (wifi != 0)
+        {
+          counters.push_back (wifi->GetCounters ());
+        }
+    }
+  return counters;
+}
+
 int64_t
 WifiHelper::AssignStreams (NetDeviceContainer c, int64_t stream)
 {
@@ -27,6 +27,8 @@
 #include "ns3/wifi-phy.h"
 #include "wifi-mac-helper.h"
 #include "ns3/wifi-remote-station-manager.h"
+#include "ns3/wifi-device-counters.h"
+#include <vector>
 
 namespace ns3 {
 
@@ -337,6 +339,27 @@ public:
    */
   static void EnableLogComponents (void);
 
+  /**
+   * Print the time each PHY of the devices has spent in each state so far:
+   * one line for the PHY of the full channel and, for HE devices, one line
+   * per RU. Times are in seconds, in the order IDLE, CCA_BUSY, TX, RX,
+   * SWITCHING and SLEEP.
+   *
+   * \param c the devices
+   * \param os the output stream
+   *
+   * \sa WifiPhy::GetCumulativeStateTime
+   */
+  static void PrintStateTimes (NetDeviceContainer c, std::ostream &os);
+  /**
+   * \param c the devices
+   * \return a snapshot of the MAC counters of each WifiNetDevice in
+   *         <i>c</i>, in the order of <i>c</i>
+   *
+   * \sa WifiNetDevice::GetCounters
+   */
+  static std::vector<WifiDeviceCounters> GetCounters (NetDeviceContainer c);
+
   /**
   * Assign a fixed random variable stream number to the random variables
   * used by the Phy and Mac aspects of the Wifi models.  Each device in
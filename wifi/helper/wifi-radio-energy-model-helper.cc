@@ -125,14 +125,23 @@ WifiRadioEnergyModelHelper::DoInstall (Ptr<NetDevice> device,
     }
   // add model to device model list in energy source
   source->AppendDeviceEnergyModel (model);
-  // create and register energy model phy listener
-  wifiPhy->RegisterListener (model->GetPhyListener ());
   //
   if (m_txCurrentModel.GetTypeId ().GetUid ())
     {
       Ptr<WifiTxCurrentModel> txcurrent = m_txCurrentModel.Create<WifiTxCurrentModel> ();
       model->SetTxCurrentModel (txcurrent);
     }
+  if (model->IsLazyAccounting ())
+    {
+      // infocom: one logical radio per device, read from the PHY of the
+      // full channel; the per-RU PHYs are not attached
+      model->SetPhy (wifiPhy);
+    }
+  else
+    {
+      // create and register energy model phy listener
+      wifiPhy->RegisterListener (model->GetPhyListener ());
+    }
   return model;
 }
 
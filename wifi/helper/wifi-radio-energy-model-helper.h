@@ -32,6 +32,9 @@ namespace ns3 {
  *
  * This installer installs WifiRadioEnergyModel for only WifiNetDevice objects.
  *
+ * With the LazyAccounting attribute of the model set, the model is attached
+ * to the PHY of the device through WifiRadioEnergyModel::SetPhy instead of
+ * being registered as a listener of that PHY.
  */
 class WifiRadioEnergyModelHelper : public DeviceEnergyModelHelper
 {
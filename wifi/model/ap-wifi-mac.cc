@@ -25,6 +25,7 @@
 #include "ns3/simulator.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include "ns3/uinteger.h"
 #include "mac-low.h"
 #include "mac-tx-middle.h"
 
@@ -74,6 +75,11 @@ ApWifiMac::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&ApWifiMac::m_disableRifs),
                    MakeBooleanChecker ())
+    .AddAttribute ("DefaultBsr",
+                   "The UL payload duration (in microseconds) assumed for a STA that has not reported a BSR yet.",
+                   UintegerValue (12932),
+                   MakeUintegerAccessor (&ApWifiMac::m_defaultBsr),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -106,6 +112,7 @@ ApWifiMac::~ApWifiMac ()
   m_staList.clear ();
   m_nonErpStations.clear ();
   m_nonHtStations.clear ();
+  m_bsrTable.clear ();
 }
 
 void
@@ -339,73 +346,44 @@ ApWifiMac::ForwardDown (Ptr<const Packet> packet, Mac48Address from,
   hdr.SetDsFrom ();
   hdr.SetDsNotTo ();
 
+  /*
+   * infocom: frames for a station allocated to an RU in a DL TF cycle stay in the
+   * SU queue, the RU transmitter of that station dequeues them from there.
+   */
+  RegularWifiMac::RUAllocations::const_iterator it = m_tfAlloc.find (to);
+  bool muDownlink = !m_muUlFlag && (m_muModeToStart || GetMuMode ()) && it != m_tfAlloc.end ();
   if (m_qosSupported)
     {
       //Sanity check that the TID is valid
       NS_ASSERT (tid < 8);
-      if (m_muModeToStart)
+      AcIndex ac = QosUtilsMapTidToAc (tid);
+      if (!muDownlink)
        {
-         RegularWifiMac::RUAllocations::const_iterator it;
-         it = m_tfAlloc.find (to);
-         if (it == m_tfAlloc.end ())
-          {
-            m_edca[QosUtilsMapTidToAc (tid)]->Queue (packet, hdr);
-          }
-         else
-          {
-            m_edcaMu[it->second][QosUtilsMapTidToAc (tid)]->QueueButDontSend (packet, hdr);
-          }
-       }
-      else if (!GetMuMode ())
-       {
-         m_edca[QosUtilsMapTidToAc (tid)]->Queue (packet, hdr);
+         m_edca[ac]->Queue (packet, hdr);
        }
-      else 
+      else
        {
-         RegularWifiMac::RUAllocations::const_iterator it;
-         it = m_tfAlloc.find (to);
-         if (it == m_tfAlloc.end ())
-          {
-            m_edca[QosUtilsMapTidToAc (tid)]->Queue (packet, hdr);
-          }
-         else
+         m_edca[ac]->QueueButDontSend (packet, hdr);
+         if (!m_muModeToStart)
           {
             m_dcfManagerMu[it->second]->UpdateBusyDuration (); // Removes BUSY state from dcfManagerMu
-            m_edcaMu[it->second][QosUtilsMapTidToAc (tid)]->Queue (packet, hdr);
+            m_edcaMu[it->second][ac]->StartAccessIfNeeded ();
           }
        }
     }
   else
     {
-      if (m_muModeToStart)
-       {
-         RegularWifiMac::RUAllocations::const_iterator it;
-         it = m_tfAlloc.find (to);
-         if (it == m_tfAlloc.end ())
-          {
-            m_edca[QosUtilsMapTidToAc (tid)]->Queue (packet, hdr);
-          }
-         else
-          {
-            m_edcaMu[it->second][QosUtilsMapTidToAc (tid)]->QueueButDontSend (packet, hdr);
-          }
-       }
-      else if (!GetMuMode ())
+      if (!muDownlink)
        {
          m_dca->Queue (packet, hdr);
        }
-      else 
+      else
        {
-         RegularWifiMac::RUAllocations::const_iterator it;
-         it = m_tfAlloc.find (to);
-         if (it == m_tfAlloc.end ())
-          {
-            m_dca->Queue (packet, hdr);
-          }
-         else
+         m_dca->QueueButDontSend (packet, hdr);
+         if (!m_muModeToStart)
           {
             m_dcfManagerMu[it->second]->UpdateBusyDuration ();
-            m_dcaMu[it->second]->Queue (packet, hdr);
+            m_dcaMu[it->second]->StartAccessIfNeeded ();
           }
        }
     }
@@ -874,7 +852,6 @@ ApWifiMac::SendTriggerFrameBeacon (void) // Sends one TF beacon
    }
 
   MgtTFBeaconHeader beacon; 
-  beacon.SetNoSta (alloc.size());
   beacon.SetRUAllocations (alloc);
   beacon.SetTfDuration (GetTfDuration ());
   packet->AddHeader (beacon);
@@ -999,7 +976,6 @@ ApWifiMac::SendTriggerFrame(bool flag)
  
   Time t1 = CalculateTfDuration ();
   MgtTFHeader tf;
-  tf.SetNoSta (m_tfAlloc.size ());
   tf.SetRUAllocations (m_tfAlloc);
   tf.SetUplinkFlag (flag);
   tf.SetTfDuration (GetTfDuration ());
@@ -1012,6 +988,10 @@ ApWifiMac::SendTriggerFrame(bool flag)
 	std::cout <<"STA = "<<it->first <<"\t RU = "<<it->second<<std::endl;
    }
   m_beaconDca->Queue (packet, hdr);
+  if (m_counters != 0)
+    {
+      m_counters->tfs++;
+    }
   m_dcfManager->UpdateBusyDuration ();
   m_beaconDca->StartAccessIfNeeded ();
   m_dcfManager->DoRestartAccessTimeoutIfNeeded ();
@@ -1044,6 +1024,7 @@ ApWifiMac::StartMuModeUplink (void) //starts the OFDMA based MU Mode
       }
    }
   m_tfAlloc = alloc;
+  UpdateTfPacketDuration ();
   m_triggerFrameUplinkEvent = Simulator::ScheduleNow (&ApWifiMac::SendTriggerFrame, this, m_muUlFlag);
 }
 
@@ -1065,22 +1046,19 @@ ApWifiMac::StartMuModeDownlink (void) //starts OFDMA mode in DL
          }
       }
   m_tfAlloc = alloc;
-  uint32_t temp[9];
-  uint32_t max_data = 0;
-  for (uint32_t i = 0; i < 9; i++)
+  for (RegularWifiMac::RUAllocations::const_iterator it = m_tfAlloc.begin (); it != m_tfAlloc.end (); ++it)
     {
-      m_phyMu[i]->SetMuMode (1); //Just making sure that all MU PHYs are in the MU Mode
-      temp[i] = m_low->CalculateApPayloadDuration (); // The data is buffered initially into regular queues, so using m_low instead of m_lowMu. Must fix after the same queue is used
+      m_dcaMu[it->second]->SetMuDestination (it->first);
+      for (EdcaQueues::const_iterator i = m_edcaMu[it->second].begin (); i != m_edcaMu[it->second].end (); ++i)
+        {
+          i->second->SetMuDestination (it->first);
+        }
     }
   for (uint32_t i = 0; i < 9; i++)
     {
-      if (temp[i] > max_data)
-       {
-         max_data = temp[i];
-       }
+      m_phyMu[i]->SetMuMode (1); //Just making sure that all MU PHYs are in the MU Mode
     }
-  m_tfPacketDuration = max_data;
-  Time t1 = CalculateTfDuration ();
+  UpdateTfPacketDuration ();
   m_triggerFrameDownlinkEvent = Simulator::ScheduleNow (&ApWifiMac::SendTriggerFrame, this, 0); //Downlink TF
 }
 
@@ -1112,16 +1090,78 @@ ApWifiMac::TxFailed (const WifiMacHeader &hdr)
     }
 }
 
+uint32_t
+ApWifiMac::GetBsr (Mac48Address sta) const
+{
+  BsrTable::const_iterator it = m_bsrTable.find (sta);
+  if (it == m_bsrTable.end ())
+    {
+      return m_defaultBsr;
+    }
+  return it->second;
+}
+
+uint32_t
+ApWifiMac::GetRandomAccessBsr (void) const
+{
+  bool reported = false;
+  uint32_t maxBsr = 0;
+  for (BsrTable::const_iterator it = m_bsrTable.begin (); it != m_bsrTable.end (); ++it)
+    {
+      if (m_tfAlloc.find (it->first) != m_tfAlloc.end ())
+        {
+          continue; // Scheduled STAs do not contend in this cycle
+        }
+      reported = true;
+      if (it->second > maxBsr)
+        {
+          maxBsr = it->second;
+        }
+    }
+  if (!reported)
+    {
+      return m_defaultBsr;
+    }
+  return maxBsr;
+}
+
+void
+ApWifiMac::UpdateTfPacketDuration (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t raBsr = 0;
+  if (m_muUlFlag)
+    {
+      raBsr = GetRandomAccessBsr ();
+    }
+  m_tfPacketDuration = 0;
+  for (RegularWifiMac::RUAllocations::const_iterator it = m_tfAlloc.begin (); it != m_tfAlloc.end (); ++it)
+    {
+      uint32_t duration;
+      if (!m_muUlFlag)
+        {
+          // DL data is buffered in the regular queues until the TF is sent
+          duration = m_low->CalculateApPayloadDuration (it->first);
+        }
+      else if (it->first == Mac48Address::GetBroadcast ())
+        {
+          duration = raBsr;
+        }
+      else
+        {
+          duration = GetBsr (it->first);
+        }
+      if (duration > m_tfPacketDuration)
+        {
+          m_tfPacketDuration = duration;
+        }
+    }
+  NS_LOG_DEBUG ("TF cycle sized for a payload of " << m_tfPacketDuration << " microseconds");
+}
+
 Time
 ApWifiMac::CalculateTfDuration (void)
 {
-  Ptr<Packet> trigger_frame = Create<Packet> ();
-  MgtTFHeader tf;
-  tf.SetNoSta (m_tfAlloc.size ());
-  tf.SetRUAllocations (m_tfAlloc);
-  tf.SetUplinkFlag (m_muUlFlag);
-  tf.SetTfDuration (GetTfDuration ());
-  trigger_frame->AddHeader (tf); 
   WifiMacHeader hdr;
   hdr.SetTriggerFrame ();
   hdr.SetAddr1 (Mac48Address::GetBroadcast());
@@ -1129,10 +1169,10 @@ ApWifiMac::CalculateTfDuration (void)
   hdr.SetAddr3 (GetAddress ());
   hdr.SetDsNotFrom ();
   hdr.SetDsNotTo ();
-  Time t1 = m_low->CalculateTfBeaconDuration (trigger_frame, hdr);
+  Time t1 = m_low->CalculateTfBeaconDuration (MgtTFHeader::GetSizeForNoSta (m_tfAlloc.size ()), hdr);
   Time t2 = MicroSeconds (m_tfPacketDuration);
   Time total;
-  if (m_tfPacketDuration > 0)
+  if (m_tfPacketDuration > 0 || (m_muUlFlag && GetNScheduled () < 9))
    {
      if (GetNScheduled () < 9)
       {
@@ -1242,10 +1282,12 @@ ApWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
           MgtTFRespHeader resp;  
           packet->RemoveHeader (resp);
          
-          if (resp.GetData () > m_tfPacketDuration)
-           {
-             m_tfPacketDuration = resp.GetData ();
-           } 
+          // The BSR sizes the next TF cycles in which this STA is served
+          m_bsrTable[from] = resp.GetData ();
+          if (m_counters != 0)
+            {
+              m_counters->bsrSuccesses++;
+            }
 
 	  std::cout<<"(m_timeToSendBsrAck - Now ()) = "<<(m_timeToSendBsrAck - Now ()).GetMicroSeconds () << std::endl;
           Simulator::Schedule (m_timeToSendBsrAck - Now (), &ApWifiMac::SendBsrAck, this, from, resp.GetRu ());
@@ -1450,6 +1492,7 @@ ApWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
           else if (hdr->IsDisassociation ())
             {
               m_stationManager->RecordDisassociated (from);
+              m_bsrTable.erase (from);
               for (std::list<Mac48Address>::const_iterator i = m_staList.begin (); i != m_staList.end (); i++)
                 {
                   if ((*i) == from)
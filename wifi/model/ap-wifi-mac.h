@@ -232,6 +232,26 @@ private:
   void SendTriggerFrameBeacon (void);
   void SendBsrAck (Mac48Address to, uint32_t ru);
   void SendTriggerFrame (bool flag);
+  /**
+   * Size the payload part of the coming TF cycle from the demand known at
+   * the AP: the head-of-line frame queued for each allocated STA in DL, and
+   * the BSR table in UL. The largest duration over the allocated RUs is
+   * stored in m_tfPacketDuration, from which CalculateTfDuration derives
+   * TfDuration.
+   */
+  void UpdateTfPacketDuration (void);
+  /**
+   * \param sta the address of the STA
+   * \return the last payload duration (in microseconds) reported by
+   *         <i>sta</i> in a BSR, or the default BSR if it never reported
+   */
+  uint32_t GetBsr (Mac48Address sta) const;
+  /**
+   * \return the payload duration (in microseconds) to reserve for a random
+   *         access RU, i.e. the largest BSR reported by the STAs that are
+   *         not scheduled in the current TF cycle
+   */
+  uint32_t GetRandomAccessBsr (void) const;
   /**
    * Return the Capability information of the current AP.
    *
@@ -319,6 +339,9 @@ private:
   Time m_lastTfBeaconAccessStart; 
   Time m_lastTfAccessStart; 
   uint32_t m_tfPacketDuration;
+  uint32_t m_defaultBsr;                     //!< infocom: payload duration assumed for STAs that have not reported a BSR yet
+  typedef std::map<Mac48Address, uint32_t> BsrTable;
+  BsrTable m_bsrTable;                       //!< infocom: last BSR (payload duration in microseconds) reported by each STA
   bool m_enableBeaconGeneration;             //!< Flag whether beacons are being generated
   EventId m_beaconEvent;                     //!< Event to generate one beacon
   EventId m_triggerFrameUplinkEvent;               //!< Event to generate one TF beacon
@@ -23,6 +23,8 @@
 #include "wifi-mac-header.h"
 #include "qos-utils.h"
 #include "ns3/log.h"
+#include <algorithm>
+#include <cstring>
 
 #define WINSIZE_ASSERT NS_ASSERT ((m_winEnd - m_winStart + 4096) % 4096 == m_winSize - 1)
 
@@ -30,6 +32,97 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("BlockAckCache");
 
+SequenceBitset::SequenceBitset ()
+{
+  Clear ();
+}
+
+void
+SequenceBitset::Clear (void)
+{
+  memset (m_words, 0, sizeof (m_words));
+}
+
+void
+SequenceBitset::Set (uint16_t seq)
+{
+  m_words[(seq % 4096) >> 6] |= (uint64_t)1 << (seq & 63);
+}
+
+void
+SequenceBitset::Reset (uint16_t seq)
+{
+  m_words[(seq % 4096) >> 6] &= ~((uint64_t)1 << (seq & 63));
+}
+
+bool
+SequenceBitset::IsSet (uint16_t seq) const
+{
+  return (m_words[(seq % 4096) >> 6] >> (seq & 63)) & 1;
+}
+
+void
+SequenceBitset::ResetRange (uint16_t start, uint16_t end)
+{
+  uint16_t n = (end - start + 4096) % 4096 + 1;
+  uint16_t done = 0;
+  while (done < n)
+    {
+      uint16_t pos = (start + done) % 4096;
+      uint16_t offset = pos & 63;
+      uint16_t len = std::min<uint16_t> (64 - offset, n - done);
+      uint64_t mask = (len == 64) ? ~(uint64_t)0 : (((uint64_t)1 << len) - 1) << offset;
+      m_words[pos >> 6] &= ~mask;
+      done += len;
+    }
+}
+
+uint64_t
+SequenceBitset::GetWindow (uint16_t start, uint16_t n) const
+{
+  NS_ASSERT (n <= 64);
+  start %= 4096;
+  uint16_t offset = start & 63;
+  uint64_t bits = m_words[start >> 6] >> offset;
+  if (offset != 0)
+    {
+      bits |= m_words[((start >> 6) + 1) % 64] << (64 - offset);
+    }
+  if (n < 64)
+    {
+      bits &= ((uint64_t)1 << n) - 1;
+    }
+  return bits;
+}
+
+uint16_t
+SequenceBitset::FindNextSet (uint16_t start, uint16_t n) const
+{
+  for (uint16_t done = 0; done < n; done += 64)
+    {
+      uint64_t bits = GetWindow (start + done, std::min<uint16_t> (64, n - done));
+      if (bits != 0)
+        {
+          return done + __builtin_ctzll (bits);
+        }
+    }
+  return n;
+}
+
+uint16_t
+SequenceBitset::FindFirstClear (uint16_t start) const
+{
+  for (uint16_t done = 0; done < 4096; done += 64)
+    {
+      uint64_t bits = ~GetWindow (start + done, 64);
+      if (bits != 0)
+        {
+          return (start + done + __builtin_ctzll (bits)) % 4096;
+        }
+    }
+  return start;
+}
+
 void
 BlockAckCache::Init (uint16_t winStart, uint16_t winSize)
 {
@@ -37,7 +130,8 @@ BlockAckCache::Init (uint16_t winStart, uint16_t winSize)
   m_winStart = winStart;
   m_winSize = winSize <= 64 ? winSize : 64;
   m_winEnd = (m_winStart + m_winSize - 1) % 4096;
-  memset (m_bitmap, 0, sizeof (m_bitmap));
+  m_firstFragments.Clear ();
+  m_otherFragments.Clear ();
 }
 
 uint16_t
@@ -65,7 +159,14 @@ BlockAckCache::UpdateWithMpdu (const WifiMacHeader *hdr)
 
           WINSIZE_ASSERT;
         }
-      m_bitmap[seqNumber] |= (0x0001 << hdr->GetFragmentNumber ());
+      if (hdr->GetFragmentNumber () == 0)
+        {
+          m_firstFragments.Set (seqNumber);
+        }
+      else
+        {
+          m_otherFragments.Set (seqNumber);
+        }
     }
 }
 
@@ -102,12 +203,8 @@ void
 BlockAckCache::ResetPortionOfBitmap (uint16_t start, uint16_t end)
 {
   NS_LOG_FUNCTION (this << start << end);
-  uint16_t i = start;
-  for (; i != end; i = (i + 1) % 4096)
-    {
-      m_bitmap[i] = 0;
-    }
-  m_bitmap[i] = 0;
+  m_firstFragments.ResetRange (start, end);
+  m_otherFragments.ResetRange (start, end);
 }
 
 bool
@@ -127,18 +224,15 @@ BlockAckCache::FillBlockAckBitmap (CtrlBAckResponseHeader *blockAckHeader)
     }
   else if (blockAckHeader->IsCompressed ())
     {
-      uint16_t i = blockAckHeader->GetStartingSequence ();
-      uint16_t end = (i + m_winSize - 1) % 4096;
-      for (; i != end; i = (i + 1) % 4096)
-        {
-          if (m_bitmap[i] == 1)
-            {
-              blockAckHeader->SetReceivedPacket (i);
-            }
-        }
-      if (m_bitmap[i] == 1)
+      //Only unfragmented MSDUs are reported, as compressed block acks carry
+      //no per-fragment information
+      uint16_t start = blockAckHeader->GetStartingSequence ();
+      uint64_t received = m_firstFragments.GetWindow (start, m_winSize)
+        & ~m_otherFragments.GetWindow (start, m_winSize);
+      while (received != 0)
         {
-          blockAckHeader->SetReceivedPacket (i);
+          blockAckHeader->SetReceivedPacket ((start + __builtin_ctzll (received)) % 4096);
+          received &= received - 1;
         }
     }
   else if (blockAckHeader->IsMultiTid ())
@@ -28,6 +28,68 @@ namespace ns3 {
 class WifiMacHeader;
 class CtrlBAckResponseHeader;
 
+/**
+ * \ingroup wifi
+ * \brief One bit per sequence number, stored in 64-bit words
+ *
+ * All ranges wrap around modulo 4096, like sequence numbers do. Range
+ * operations work a word at a time, so scanning or clearing a block ack
+ * window costs a handful of word operations whatever its size.
+ */
+class SequenceBitset
+{
+public:
+  SequenceBitset ();
+
+  /**
+   * Clear all the bits.
+   */
+  void Clear (void);
+  /**
+   * \param seq the sequence number
+   */
+  void Set (uint16_t seq);
+  /**
+   * \param seq the sequence number
+   */
+  void Reset (uint16_t seq);
+  /**
+   * \param seq the sequence number
+   * \returns true if the bit of the given sequence number is set
+   */
+  bool IsSet (uint16_t seq) const;
+  /**
+   * Clear the bits from <i>start</i> to <i>end</i>, both included.
+   * \param start the first sequence number
+   * \param end the last sequence number
+   */
+  void ResetRange (uint16_t start, uint16_t end);
+  /**
+   * \param start the first sequence number
+   * \param n the number of bits (at most 64)
+   * \returns the bits from <i>start</i> to <i>start</i> + <i>n</i> - 1,
+   *          the bit of <i>start</i> being the least significant one
+   */
+  uint64_t GetWindow (uint16_t start, uint16_t n) const;
+  /**
+   * \param start the first sequence number
+   * \param n the number of sequence numbers to look at
+   * \returns the offset from <i>start</i> of the first set bit among the
+   *          <i>n</i> sequence numbers following <i>start</i>, or <i>n</i> if none is set
+   */
+  uint16_t FindNextSet (uint16_t start, uint16_t n) const;
+  /**
+   * \param start the first sequence number
+   * \returns the first sequence number from <i>start</i> onwards whose bit
+   *          is clear, or <i>start</i> if all the bits are set
+   */
+  uint16_t FindFirstClear (uint16_t start) const;
+
+
+private:
+  uint64_t m_words[4096 / 64]; ///< the bits
+};
+
 /**
  * \ingroup wifi
  * \brief BlockAckCache cache
@@ -86,7 +148,8 @@ private:
   uint8_t m_winSize; ///< window size
   uint16_t m_winEnd; ///< window end
 
-  uint16_t m_bitmap[4096]; ///< bitmap
+  SequenceBitset m_firstFragments; ///< sequence numbers whose fragment 0 has been received
+  SequenceBitset m_otherFragments; ///< sequence numbers for which another fragment has been received
 };
 
 } //namespace ns3
@@ -42,6 +42,12 @@ BlockAckManager::Item::Item (Ptr<const Packet> packet, const WifiMacHeader &hdr,
   NS_LOG_FUNCTION (this << packet << hdr << tStamp);
 }
 
+BlockAckManager::RetryIndex::RetryIndex ()
+  : count (4096, 0),
+    nSeqs (0)
+{
+}
+
 Bar::Bar ()
 {
   NS_LOG_FUNCTION (this);
@@ -80,6 +86,7 @@ BlockAckManager::~BlockAckManager ()
   m_queue = 0;
   m_agreements.clear ();
   m_retryPackets.clear ();
+  m_retryIndexes.clear ();
 }
 
 bool
@@ -162,6 +169,7 @@ BlockAckManager::DestroyAgreement (Mac48Address recipient, uint8_t tid)
               i++;
             }
         }
+      m_retryIndexes.erase (std::make_pair (recipient, tid));
       m_agreements.erase (it);
       //remove scheduled bar
       for (std::list<Bar>::const_iterator i = m_bars.begin (); i != m_bars.end (); )
@@ -280,8 +288,9 @@ BlockAckManager::GetNextPacket (WifiMacHeader &hdr)
             {
               //Standard says the originator should not send a packet with seqnum < winstart
               NS_LOG_DEBUG ("The Retry packet have sequence number < WinStartO --> Discard " << (*it)->hdr.GetSequenceNumber () << " " << agreement->second.first.GetStartingSequence ());
-              agreement->second.second.erase ((*it));
-              it = m_retryPackets.erase (it);
+              PacketQueueI item = *it;
+              it = EraseFromRetryQueue (it);
+              agreement->second.second.erase (item);
               continue;
             }
           else if ((*it)->hdr.GetSequenceNumber () > (agreement->second.first.GetStartingSequence () + 63) % 4096)
@@ -306,6 +315,7 @@ BlockAckManager::GetNextPacket (WifiMacHeader &hdr)
                   || SwitchToBlockAckIfNeeded (recipient, tid, hdr.GetSequenceNumber ())))
             {
               hdr.SetQosAckPolicy (WifiMacHeader::BLOCK_ACK);
+              it = EraseFromRetryQueue (it);
             }
           else
             {
@@ -318,9 +328,10 @@ BlockAckManager::GetNextPacket (WifiMacHeader &hdr)
                */
               hdr.SetQosAckPolicy (WifiMacHeader::NORMAL_ACK);
               AgreementsI i = m_agreements.find (std::make_pair (recipient, tid));
-              i->second.second.erase (*it);
+              PacketQueueI item = *it;
+              it = EraseFromRetryQueue (it);
+              i->second.second.erase (item);
             }
-          it = m_retryPackets.erase (it);
           NS_LOG_DEBUG ("Removed one packet, retry buffer size = " << m_retryPackets.size () );
           break;
         }
@@ -396,6 +407,10 @@ BlockAckManager::PeekNextPacketByTidAndAddress (WifiMacHeader &hdr, Mac48Address
   CleanupBuffers ();
   AgreementsI agreement = m_agreements.find (std::make_pair (recipient, tid));
   NS_ASSERT (agreement != m_agreements.end ());
+  if (GetNRetryNeededPackets (recipient, tid) == 0)
+    {
+      return packet;
+    }
   std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
   for (; it != m_retryPackets.end (); it++)
     {
@@ -409,8 +424,9 @@ BlockAckManager::PeekNextPacketByTidAndAddress (WifiMacHeader &hdr, Mac48Address
             {
               //standard says the originator should not send a packet with seqnum < winstart
               NS_LOG_DEBUG ("The Retry packet have sequence number < WinStartO --> Discard " << (*it)->hdr.GetSequenceNumber () << " " << agreement->second.first.GetStartingSequence ());
-              agreement->second.second.erase ((*it));
-              it = m_retryPackets.erase (it);
+              PacketQueueI item = *it;
+              it = EraseFromRetryQueue (it);
+              agreement->second.second.erase (item);
               it--;
               continue;
             }
@@ -451,7 +467,10 @@ BlockAckManager::PeekNextPacketByTidAndAddress (WifiMacHeader &hdr, Mac48Address
 bool
 BlockAckManager::RemovePacket (uint8_t tid, Mac48Address recipient, uint16_t seqnumber)
 {
-
+  if (!AlreadyExists (seqnumber, recipient, tid))
+    {
+      return false;
+    }
   std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
   for (; it != m_retryPackets.end (); it++)
     {
@@ -466,9 +485,9 @@ BlockAckManager::RemovePacket (uint8_t tid, Mac48Address recipient, uint16_t seq
           Mac48Address recipient = hdr.GetAddr1 ();
 
           AgreementsI i = m_agreements.find (std::make_pair (recipient, tid));
-          i->second.second.erase ((*it));
-
-          m_retryPackets.erase (it);
+          PacketQueueI item = *it;
+          EraseFromRetryQueue (it);
+          i->second.second.erase (item);
           NS_LOG_DEBUG ("Removed Packet from retry queue = " << hdr.GetSequenceNumber () << " " << (uint16_t)tid << " " << recipient << " Buffer Size = " << m_retryPackets.size ());
           return true;
         }
@@ -526,31 +545,13 @@ BlockAckManager::GetNRetryNeededPackets (Mac48Address recipient, uint8_t tid) co
 {
   NS_LOG_FUNCTION (this << recipient << (uint16_t)tid);
   uint32_t nPackets = 0;
-  uint16_t currentSeq = 0;
   if (ExistsAgreement (recipient, tid))
     {
-      std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
-      while (it != m_retryPackets.end ())
+      /* a fragmented packet must be counted as one packet */
+      RetryIndexes::const_iterator index = m_retryIndexes.find (std::make_pair (recipient, tid));
+      if (index != m_retryIndexes.end ())
         {
-          if (!(*it)->hdr.IsQosData ())
-            {
-              NS_FATAL_ERROR ("Packet in blockAck manager retry queue is not Qos Data");
-            }
-          if ((*it)->hdr.GetAddr1 () == recipient && (*it)->hdr.GetQosTid () == tid)
-            {
-              currentSeq = (*it)->hdr.GetSequenceNumber ();
-              nPackets++;
-              /* a fragmented packet must be counted as one packet */
-              while (it != m_retryPackets.end () && (*it)->hdr.GetSequenceNumber () == currentSeq)
-                {
-                  it++;
-                }
-            }
-          //go to next packet
-          else
-            {
-              it++;
-            }
+          nPackets = index->second.nSeqs;
         }
     }
   return nPackets;
@@ -573,21 +574,9 @@ BlockAckManager::SetWifiRemoteStationManager (const Ptr<WifiRemoteStationManager
 bool
 BlockAckManager::AlreadyExists (uint16_t currentSeq, Mac48Address recipient, uint8_t tid) const
 {
-  std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
-  while (it != m_retryPackets.end ())
-    {
-      NS_LOG_FUNCTION (this << (*it)->hdr.GetType ());
-      if (!(*it)->hdr.IsQosData ())
-        {
-          NS_FATAL_ERROR ("Packet in blockAck manager retry queue is not Qos Data");
-        }
-      if ((*it)->hdr.GetAddr1 () == recipient && (*it)->hdr.GetQosTid () == tid && currentSeq == (*it)->hdr.GetSequenceNumber ())
-        {
-          return true;
-        }
-      it++;
-    }
-  return false;
+  NS_LOG_FUNCTION (this << currentSeq << recipient << (uint16_t)tid);
+  RetryIndexes::const_iterator index = m_retryIndexes.find (std::make_pair (recipient, tid));
+  return index != m_retryIndexes.end () && index->second.count[currentSeq] > 0;
 }
 
 void
@@ -626,6 +615,10 @@ BlockAckManager::NotifyGotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac4
                                                     (*queueIt).hdr.GetFragmentNumber ()))
                     {
                       nSuccessfulMpdus++;
+                      if (!m_mpduAckedCallback.IsNull ())
+                        {
+                          m_mpduAckedCallback ((*queueIt).timestamp);
+                        }
                       RemoveFromRetryQueue (recipient, tid, (*queueIt).hdr.GetSequenceNumber ());
                       queueIt = it->second.second.erase (queueIt);
                     }
@@ -661,6 +654,10 @@ BlockAckManager::NotifyGotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac4
                             {
                               m_txOkCallback ((*queueIt).hdr);
                             }
+                          if (!m_mpduAckedCallback.IsNull ())
+                            {
+                              m_mpduAckedCallback ((*queueIt).timestamp);
+                            }
                           RemoveFromRetryQueue (recipient, tid, currentSeq);
                           queueIt = it->second.second.erase (queueIt);
                         }
@@ -890,14 +887,20 @@ void
 BlockAckManager::RemoveFromRetryQueue (Mac48Address address, uint8_t tid, uint16_t seq)
 {
   /* remove retry packet iterator if it's present in retry queue */
+  RetryIndexes::iterator index = m_retryIndexes.find (std::make_pair (address, tid));
+  if (index == m_retryIndexes.end ())
+    {
+      return;
+    }
+  uint8_t &count = index->second.count[seq];
   std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
-  while (it != m_retryPackets.end ())
+  while (count > 0 && it != m_retryPackets.end ())
     {
       if ((*it)->hdr.GetAddr1 () == address
           && (*it)->hdr.GetQosTid () == tid
           && (*it)->hdr.GetSequenceNumber () == seq)
         {
-          it = m_retryPackets.erase (it);
+          it = EraseFromRetryQueue (it);
         }
       else
         {
@@ -906,6 +909,20 @@ BlockAckManager::RemoveFromRetryQueue (Mac48Address address, uint8_t tid, uint16
     }
 }
 
+std::list<BlockAckManager::PacketQueueI>::const_iterator
+BlockAckManager::EraseFromRetryQueue (std::list<PacketQueueI>::const_iterator it)
+{
+  RetryIndexes::iterator index = m_retryIndexes.find (std::make_pair ((*it)->hdr.GetAddr1 (), (*it)->hdr.GetQosTid ()));
+  NS_ASSERT (index != m_retryIndexes.end ());
+  uint8_t &count = index->second.count[(*it)->hdr.GetSequenceNumber ()];
+  NS_ASSERT (count > 0);
+  if (--count == 0)
+    {
+      index->second.nSeqs--;
+    }
+  return m_retryPackets.erase (it);
+}
+
 void
 BlockAckManager::CleanupBuffers (void)
 {
@@ -976,6 +993,10 @@ uint16_t
 BlockAckManager::GetSeqNumOfNextRetryPacket (Mac48Address recipient, uint8_t tid) const
 {
   NS_LOG_FUNCTION (this << recipient << (uint16_t)tid);
+  if (GetNRetryNeededPackets (recipient, tid) == 0)
+    {
+      return 4096;
+    }
   std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
   while (it != m_retryPackets.end ())
     {
@@ -1004,10 +1025,21 @@ BlockAckManager::SetTxFailedCallback (TxFailed callback)
   m_txFailedCallback = callback;
 }
 
+void
+BlockAckManager::SetMpduAckedCallback (MpduAcked callback)
+{
+  m_mpduAckedCallback = callback;
+}
+
 void
 BlockAckManager::InsertInRetryQueue (PacketQueueI item)
 {
   NS_LOG_INFO ("Adding to retry queue " << (*item).hdr.GetSequenceNumber ());
+  RetryIndex &index = m_retryIndexes[std::make_pair ((*item).hdr.GetAddr1 (), (*item).hdr.GetQosTid ())];
+  if (index.count[(*item).hdr.GetSequenceNumber ()]++ == 0)
+    {
+      index.nSeqs++;
+    }
   if (m_retryPackets.size () == 0)
     {
       m_retryPackets.push_back (item);
@@ -27,6 +27,7 @@
 #include "qos-utils.h"
 #include "wifi-remote-station-manager.h"
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -401,6 +402,18 @@ public:
    * packet transmission was completed unsuccessfully.
    */
   void SetTxFailedCallback (TxFailed callback);
+  /**
+   * typedef for a callback to invoke with the timestamp of every
+   * MPDU acknowledged by a Block Ack. It is invoked while the Block Ack
+   * is processed, i.e., in the frame exchange that carried it, whatever
+   * the number of earlier attempts of the MPDU.
+   */
+  typedef Callback <void, Time> MpduAcked;
+  /**
+   * \param callback the callback to invoke with the timestamp of every
+   * MPDU acknowledged by a Block Ack.
+   */
+  void SetMpduAckedCallback (MpduAcked callback);
 
 
 private:
@@ -495,6 +508,31 @@ private:
    * \param seq sequence number of the packet to be removed
    */
   void RemoveFromRetryQueue (Mac48Address address, uint8_t tid, uint16_t seq);
+  /**
+   * Erase an entry of the retransmission queue and update the retry index
+   * of its agreement.
+   *
+   * \param it the entry to erase
+   * \return the entry that followed the erased one
+   */
+  std::list<PacketQueueI>::const_iterator EraseFromRetryQueue (std::list<PacketQueueI>::const_iterator it);
+
+  /**
+   * Per-agreement count of the retransmission queue entries of each
+   * sequence number. It is directly indexed by sequence number over the
+   * whole 12-bit sequence space, so that membership tests and per-agreement
+   * counts never walk m_retryPackets.
+   */
+  struct RetryIndex
+  {
+    RetryIndex ();
+    std::vector<uint8_t> count; ///< number of entries (fragments) in the retransmission queue per sequence number
+    uint32_t nSeqs;             ///< number of sequence numbers having entries in the retransmission queue
+  };
+  /**
+   * typedef for a map between (recipient, TID) and retry index.
+   */
+  typedef std::map<std::pair<Mac48Address, uint8_t>, RetryIndex> RetryIndexes;
 
   /**
    * This data structure contains, for each block ack agreement (recipient, tid), a set of packets
@@ -510,6 +548,7 @@ private:
    * frame.
    */
   std::list<PacketQueueI> m_retryPackets;
+  RetryIndexes m_retryIndexes; ///< per-agreement index of m_retryPackets
   std::list<Bar> m_bars; ///< list of BARs
 
   uint8_t m_blockAckThreshold; ///< bock ack threshold
@@ -523,6 +562,7 @@ private:
   Callback<void, Mac48Address, uint8_t> m_unblockPackets; ///< unblock packets callback
   TxOk m_txOkCallback; ///< transmit ok callback
   TxFailed m_txFailedCallback; ///< transmit failed callback
+  MpduAcked m_mpduAckedCallback; ///< MPDU acknowledged callback
   Ptr<WifiRemoteStationManager> m_stationManager; ///< the station manager
 };
 
@@ -80,6 +80,7 @@ DcaTxop::DcaTxop ()
   m_rng = CreateObject<UniformRandomVariable> ();
   m_muMode = 0;
   m_ruBits = 0;
+  m_hasMuDestination = false;
 }
 
 DcaTxop::~DcaTxop ()
@@ -92,8 +93,10 @@ DcaTxop::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
   m_queue = 0;
+  m_muSource = 0;
   m_low = 0;
   m_stationManager = 0;
+  m_latencyStats = 0;
   m_dcf = 0;
   m_rng = 0;
   m_txMiddle = 0;
@@ -149,6 +152,13 @@ DcaTxop::SetTxDroppedCallback (TxDropped callback)
   m_queue->TraceConnectWithoutContext ("Drop", MakeCallback (&DcaTxop::TxDroppedPacket, this));
 }
 
+void
+DcaTxop::SetLatencyStats (Ptr<WifiLatencyStats> stats)
+{
+  NS_LOG_FUNCTION (this);
+  m_latencyStats = stats;
+}
+
 void
 DcaTxop::SetTfAccessGrantCallback (Callback<void> callback)
 { 
@@ -291,7 +301,7 @@ DcaTxop::RestartAccessIfNeeded (void)
 {
   NS_LOG_FUNCTION (this);
   if ((m_currentPacket != 0
-       || !m_queue->IsEmpty ())
+       || !m_queue->IsEmpty () || HasMuSourcePacket ())
       && !m_dcf->IsAccessRequested ())
     {
       m_manager->RequestAccess (m_dcf);
@@ -303,7 +313,7 @@ DcaTxop::StartAccessIfNeeded (void)
 {
   NS_LOG_FUNCTION (this);
   if (m_currentPacket == 0
-      && !m_queue->IsEmpty ()
+      && (!m_queue->IsEmpty () || HasMuSourcePacket ())
       && !m_dcf->IsAccessRequested ())
     {
       m_manager->RequestAccess (m_dcf);
@@ -417,8 +427,75 @@ DcaTxop::StopMuMode (void)
   m_queue->RemoveAll ();
   if (m_currentPacket!=0)
    {
+    if (m_muSource != 0 && m_currentHdr.IsData ())
+      {
+        //infocom: a data frame pulled from the SU queue but not delivered in this TF cycle goes back to the SU path,
+        //keeping its enqueue time so that its MaxDelay lifetime and its latency still count from its first enqueue
+        m_currentHdr.SetNoRetry ();
+        m_muSource->PushFront (Create<WifiMacQueueItem> (m_currentPacket, m_currentHdr, m_currentPacketTimestamp));
+      }
     m_currentPacket = 0;
    }
+  ClearMuDestination ();
+}
+
+void
+DcaTxop::SetMuSource (Ptr<WifiMacQueue> source)
+{
+  NS_LOG_FUNCTION (this << source);
+  m_muSource = source;
+}
+
+Ptr<WifiMacQueue>
+DcaTxop::GetMuSource (void) const
+{
+  return m_muSource;
+}
+
+void
+DcaTxop::SetMuDestination (Mac48Address dest)
+{
+  NS_LOG_FUNCTION (this << dest);
+  m_muDestination = dest;
+  m_hasMuDestination = true;
+}
+
+void
+DcaTxop::ClearMuDestination (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_hasMuDestination = false;
+}
+
+bool
+DcaTxop::HasMuSourcePacket (void) const
+{
+  if (m_muSource == 0 || !m_hasMuDestination)
+    {
+      return false;
+    }
+  return m_muSource->PeekByAddress (WifiMacHeader::ADDR1, m_muDestination) != 0;
+}
+
+Ptr<WifiMacQueueItem>
+DcaTxop::DequeueMuSource (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_muSource == 0 || !m_hasMuDestination)
+    {
+      return 0;
+    }
+  return m_muSource->DequeueByAddress (WifiMacHeader::ADDR1, m_muDestination);
+}
+
+void
+DcaTxop::NotifyMpduAcked (Time enqueued)
+{
+  if (m_latencyStats != 0)
+    {
+      m_latencyStats->NotifyAcked (enqueued, m_dcf->GetAccessRequestTime (),
+                                   m_dcf->GetAccessGrantTime (), m_low->GetTransmissionStart ());
+    }
 }
 
 Ptr<Packet>
@@ -446,7 +523,7 @@ bool
 DcaTxop::NeedsAccess (void) const
 {
   NS_LOG_FUNCTION (this);
-  return !m_queue->IsEmpty () || m_currentPacket != 0;
+  return !m_queue->IsEmpty () || m_currentPacket != 0 || HasMuSourcePacket ();
 }
 
 void
@@ -455,15 +532,23 @@ DcaTxop::NotifyAccessGranted (void)
   NS_LOG_FUNCTION (this);
   if (m_currentPacket == 0)
     {
-      if (m_queue->IsEmpty ())
+      Ptr<WifiMacQueueItem> item;
+      if (!m_queue->IsEmpty ())
+        {
+          item = m_queue->Dequeue ();
+        }
+      else
+        {
+          item = DequeueMuSource ();
+        }
+      if (item == 0)
         {
           NS_LOG_DEBUG ("queue empty");
           return;
         }
-      Ptr<WifiMacQueueItem> item = m_queue->Dequeue ();
-      NS_ASSERT (item != 0);
       m_currentPacket = item->GetPacket ();
       m_currentHdr = item->GetHeader ();
+      m_currentPacketTimestamp = item->GetTimeStamp ();
       NS_ASSERT (m_currentPacket != 0);
       uint16_t sequence = m_txMiddle->GetNextSequenceNumberFor (&m_currentHdr);
       m_currentHdr.SetSequenceNumber (sequence);
@@ -608,6 +693,10 @@ DcaTxop::GotAck (void)
         {
           m_txOkCallback (m_currentHdr);
         }
+      if (m_currentHdr.IsData ())
+        {
+          NotifyMpduAcked (m_currentPacketTimestamp);
+        }
 
       /* we are not fragmenting or we are done fragmenting
        * so we can get rid of that packet now.
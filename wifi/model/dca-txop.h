@@ -24,6 +24,7 @@
 #include "mac-low.h"
 #include "wifi-mac-header.h"
 #include "wifi-remote-station-manager.h"
+#include "wifi-latency-histogram.h"
 
 namespace ns3 {
 
@@ -133,6 +134,11 @@ public:
    * packet is dropped.
    */
   void SetTxDroppedCallback (TxDropped callback);
+  /**
+   * \param stats the latency histograms of the device, updated with the
+   *        data MPDUs acknowledged to this DcaTxop
+   */
+  void SetLatencyStats (Ptr<WifiLatencyStats> stats);
   /**
    *
    *
@@ -141,6 +147,30 @@ public:
   void SetTfAccessGrantCallback (Callback<void> callback);
 
   void StopMuMode (void);
+  /**
+   * infocom: make this per-RU transmitter pull its data frames from the
+   * queue of the SU transmitter instead of keeping its own copies. The
+   * private queue is still used, first, for control frames (TF response,
+   * BSR ack).
+   *
+   * \param source the SU queue shared with this transmitter
+   */
+  void SetMuSource (Ptr<WifiMacQueue> source);
+  /**
+   * \return the SU queue shared with this transmitter, if any
+   */
+  Ptr<WifiMacQueue> GetMuSource (void) const;
+  /**
+   * infocom: select the station whose frames are pulled from the shared
+   * SU queue during the current TF cycle.
+   *
+   * \param dest the station allocated to this RU
+   */
+  void SetMuDestination (Mac48Address dest);
+  /**
+   * infocom: stop pulling frames from the shared SU queue.
+   */
+  void ClearMuDestination (void);
   /**
    * Return the MacLow associated with this DcaTxop.
    *
@@ -414,6 +444,26 @@ protected:
    * \param item the wifi MAC queue item.
    */
   void TxDroppedPacket (Ptr<const WifiMacQueueItem> item);
+  /**
+   * \return true if the shared SU queue holds a frame for the station
+   *         allocated to this RU
+   */
+  bool HasMuSourcePacket (void) const;
+  /**
+   * Remove from the shared SU queue the next frame for the station
+   * allocated to this RU.
+   *
+   * \return the dequeued item, or 0 if there is none
+   */
+  Ptr<WifiMacQueueItem> DequeueMuSource (void);
+  /**
+   * Record in the latency histograms, if any, a data MPDU acknowledged now.
+   * The access and air time are those of the current frame exchange (see
+   * WifiLatencyStats for the earlier attempts).
+   *
+   * \param enqueued the time the MPDU was enqueued
+   */
+  void NotifyMpduAcked (Time enqueued);
 
   Ptr<DcfState> m_dcf; //!< the DCF state
   Ptr<DcfManager> m_manager; //!< the DCF manager
@@ -427,13 +477,18 @@ protected:
   Ptr <MacLow> m_low; //!< the MacLow
   Ptr<WifiRemoteStationManager> m_stationManager; //!< the wifi remote station manager
   Ptr<UniformRandomVariable> m_rng; //!<  the random stream
+  Ptr<WifiLatencyStats> m_latencyStats; //!< latency histograms of the device, if any
 
   Ptr<const Packet> m_currentPacket; //!< the current packet
   WifiMacHeader m_currentHdr; //!< the current header
+  Time m_currentPacketTimestamp; //!< the current packet timestamp
   MacLowTransmissionParameters m_currentParams; ///< current transmission parameters
   uint8_t m_fragmentNumber; //!< the fragment number
   uint32_t m_ruBits;
   bool m_muMode;
+  Ptr<WifiMacQueue> m_muSource; //!< infocom: SU queue shared with this RU
+  Mac48Address m_muDestination; //!< infocom: station allocated to this RU
+  bool m_hasMuDestination; //!< infocom: whether m_muDestination is valid
 };
 
 } //namespace ns3
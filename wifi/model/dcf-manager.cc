@@ -21,6 +21,8 @@
 #include "ns3/log.h"
 #include "dcf-manager.h"
 #include "dcf-state.h"
+#include "shared-medium-contention.h"
+#include "ns3/hot-path-profiler.h"
 
 namespace ns3 {
 
@@ -105,7 +107,8 @@ DcfManager::DcfManager ()
     m_sleeping (false),
     m_slotTimeUs (0),
     m_sifs (Seconds (0.0)),
-    m_phyListener (0)
+    m_phyListener (0),
+    m_accessGrantStartValid (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -114,6 +117,10 @@ DcfManager::~DcfManager ()
 {
   delete m_phyListener;
   m_phyListener = 0;
+  if (m_contention != 0)
+    {
+      m_contention->Cancel (this);
+    }
 }
 
 void
@@ -126,6 +133,30 @@ DcfManager::SetupPhyListener (Ptr<WifiPhy> phy)
     }
   m_phyListener = new PhyListener (this);
   phy->RegisterListener (m_phyListener);
+  Ptr<Channel> channel = phy->GetChannel ();
+  if (channel != 0 && channel->GetObject<SharedMediumContention> () != 0)
+    {
+      SetSharedMediumContention (channel->GetObject<SharedMediumContention> ());
+    }
+}
+
+void
+DcfManager::SetSharedMediumContention (Ptr<SharedMediumContention> contention)
+{
+  NS_LOG_FUNCTION (this << contention);
+  if (contention == m_contention)
+    {
+      return;
+    }
+  //Move a pending access timeout over to the new owner
+  bool running = IsAccessTimeoutRunning ();
+  Time delay = running ? GetAccessTimeoutDelayLeft () : Seconds (0);
+  CancelAccessTimeout ();
+  m_contention = contention;
+  if (running)
+    {
+      ScheduleAccessTimeout (delay);
+    }
 }
 
 void
@@ -159,6 +190,7 @@ DcfManager::SetSifs (Time sifs)
 {
   NS_LOG_FUNCTION (this << sifs);
   m_sifs = sifs;
+  InvalidateAccessGrantStart ();
 }
 
 void
@@ -166,6 +198,7 @@ DcfManager::SetEifsNoDifs (Time eifsNoDifs)
 {
   NS_LOG_FUNCTION (this << eifsNoDifs);
   m_eifsNoDifs = eifsNoDifs;
+  InvalidateAccessGrantStart ();
 }
 
 Time
@@ -221,19 +254,6 @@ DcfManager::MostRecent (Time a, Time b, Time c, Time d, Time e, Time f) const
   return retval;
 }
 
-Time
-DcfManager::MostRecent (Time a, Time b, Time c, Time d, Time e, Time f, Time g) const
-{
-  NS_LOG_FUNCTION (this << a << b << c << d << e << f << g);
-  Time h = Max (a, b);
-  Time i = Max (c, d);
-  Time j = Max (e, f);
-  Time k = Max (h, i);
-  Time l = Max (j, g);
-  Time retval = Max (k, l);
-  return retval;
-}
-
 bool
 DcfManager::IsBusy (void) const
 {
@@ -390,10 +410,66 @@ DcfManager::AccessTimeout (void)
   DoRestartAccessTimeoutIfNeeded ();
 }
 
+void
+DcfManager::InvalidateAccessGrantStart (void)
+{
+  m_accessGrantStartValid = false;
+}
+
+bool
+DcfManager::IsAccessTimeoutRunning (void) const
+{
+  if (m_contention != 0)
+    {
+      return m_contention->IsScheduled (this);
+    }
+  return m_accessTimeout.IsRunning ();
+}
+
+Time
+DcfManager::GetAccessTimeoutDelayLeft (void) const
+{
+  if (m_contention != 0)
+    {
+      return m_contention->GetDelayLeft (this);
+    }
+  return Simulator::GetDelayLeft (m_accessTimeout);
+}
+
+void
+DcfManager::CancelAccessTimeout (void)
+{
+  if (m_contention != 0)
+    {
+      m_contention->Cancel (this);
+    }
+  else
+    {
+      m_accessTimeout.Cancel ();
+    }
+}
+
+void
+DcfManager::ScheduleAccessTimeout (Time delay)
+{
+  if (m_contention != 0)
+    {
+      m_contention->Schedule (this, delay);
+    }
+  else
+    {
+      m_accessTimeout = Simulator::Schedule (delay, &DcfManager::AccessTimeout, this);
+    }
+}
+
 Time
 DcfManager::GetAccessGrantStart (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_accessGrantStartValid)
+    {
+      return m_accessGrantStart;
+    }
   Time rxAccessStart;
   if (!m_rxing)
     {
@@ -407,26 +483,17 @@ DcfManager::GetAccessGrantStart (void) const
     {
       rxAccessStart = m_lastRxStart + m_lastRxDuration + m_sifs;
     }
-  Time busyAccessStart = m_lastBusyStart + m_lastBusyDuration + m_sifs;
-  Time txAccessStart = m_lastTxStart + m_lastTxDuration + m_sifs;
-  Time navAccessStart = m_lastNavStart + m_lastNavDuration + m_sifs;
-  Time ackTimeoutAccessStart = m_lastAckTimeoutEnd + m_sifs;
-  Time ctsTimeoutAccessStart = m_lastCtsTimeoutEnd + m_sifs;
-  Time switchingAccessStart = m_lastSwitchingStart + m_lastSwitchingDuration + m_sifs;
-  Time accessGrantedStart = MostRecent (rxAccessStart,
-                                        busyAccessStart,
-                                        txAccessStart,
-                                        navAccessStart,
-                                        ackTimeoutAccessStart,
-                                        ctsTimeoutAccessStart,
-                                        switchingAccessStart
-                                        );
-  NS_LOG_INFO ("access grant start=" << accessGrantedStart <<
+  //the medium is idle once every source of busyness has ended
+  Time lastBusyEnd = Max (m_lastBusyStart + m_lastBusyDuration, m_lastTxStart + m_lastTxDuration);
+  lastBusyEnd = Max (lastBusyEnd, m_lastNavStart + m_lastNavDuration);
+  lastBusyEnd = Max (lastBusyEnd, Max (m_lastAckTimeoutEnd, m_lastCtsTimeoutEnd));
+  lastBusyEnd = Max (lastBusyEnd, m_lastSwitchingStart + m_lastSwitchingDuration);
+  m_accessGrantStart = Max (rxAccessStart, lastBusyEnd + m_sifs);
+  m_accessGrantStartValid = true;
+  NS_LOG_INFO ("access grant start=" << m_accessGrantStart <<
                ", rx access start=" << rxAccessStart <<
-               ", busy access start=" << busyAccessStart <<
-               ", tx access start=" << txAccessStart <<
-               ", nav access start=" << navAccessStart);
-  return accessGrantedStart;
+               ", last busy end=" << lastBusyEnd);
+  return m_accessGrantStart;
 }
 
 Time
@@ -443,16 +510,18 @@ Time
 DcfManager::GetBackoffEndFor (Ptr<DcfState> state)
 {
   NS_LOG_FUNCTION (this << state);
-  NS_LOG_DEBUG ("Backoff start: " << GetBackoffStartFor (state).As (Time::US) <<
-                " end: " << (GetBackoffStartFor (state) +
-                             MicroSeconds (state->GetBackoffSlots () * m_slotTimeUs)).As (Time::US));
-  return GetBackoffStartFor (state) + MicroSeconds (state->GetBackoffSlots () * m_slotTimeUs);
+  Time backoffStart = GetBackoffStartFor (state);
+  Time backoffEnd = backoffStart + MicroSeconds (state->GetBackoffSlots () * m_slotTimeUs);
+  NS_LOG_DEBUG ("Backoff start: " << backoffStart.As (Time::US) <<
+                " end: " << backoffEnd.As (Time::US));
+  return backoffEnd;
 }
 
 void
 DcfManager::UpdateBackoff (void)
 {
   NS_LOG_FUNCTION (this);
+  NS_PROFILE_FUNCTION ("DcfManager::UpdateBackoff");
   uint32_t k = 0;
   for (States::iterator i = m_states.begin (); i != m_states.end (); i++, k++)
     {
@@ -514,15 +583,14 @@ DcfManager::DoRestartAccessTimeoutIfNeeded (void)
     {
       NS_LOG_DEBUG ("expected backoff end=" << expectedBackoffEnd);
       Time expectedBackoffDelay = expectedBackoffEnd - Simulator::Now ();
-      if (m_accessTimeout.IsRunning ()
-          && Simulator::GetDelayLeft (m_accessTimeout) > expectedBackoffDelay)
+      if (IsAccessTimeoutRunning ()
+          && GetAccessTimeoutDelayLeft () > expectedBackoffDelay)
         {
-          m_accessTimeout.Cancel ();
+          CancelAccessTimeout ();
         }
-      if (m_accessTimeout.IsExpired ())
+      if (!IsAccessTimeoutRunning ())
         {
-          m_accessTimeout = Simulator::Schedule (expectedBackoffDelay,
-                                                 &DcfManager::AccessTimeout, this);
+          ScheduleAccessTimeout (expectedBackoffDelay);
         }
     }
 }
@@ -536,6 +604,7 @@ DcfManager::NotifyRxStartNow (Time duration)
   m_lastRxStart = Simulator::Now ();
   m_lastRxDuration = duration;
   m_rxing = true;
+  InvalidateAccessGrantStart ();
 }
 
 void
@@ -546,6 +615,7 @@ DcfManager::NotifyRxEndOkNow (void)
   m_lastRxEnd = Simulator::Now ();
   m_lastRxReceivedOk = true;
   m_rxing = false;
+  InvalidateAccessGrantStart ();
 }
 
 void
@@ -556,6 +626,7 @@ DcfManager::NotifyRxEndErrorNow (void)
   m_lastRxEnd = Simulator::Now ();
   m_lastRxReceivedOk = false;
   m_rxing = false;
+  InvalidateAccessGrantStart ();
 }
 
 void
@@ -571,11 +642,13 @@ DcfManager::NotifyTxStartNow (Time duration)
       m_lastRxDuration = m_lastRxEnd - m_lastRxStart;
       m_lastRxReceivedOk = true;
       m_rxing = false;
+      InvalidateAccessGrantStart ();
     }
   NS_LOG_DEBUG ("tx start for " << duration);
   UpdateBackoff ();
   m_lastTxStart = Simulator::Now ();
   m_lastTxDuration = duration;
+  InvalidateAccessGrantStart ();
 }
 
 void
@@ -586,6 +659,7 @@ DcfManager::NotifyMaybeCcaBusyStartNow (Time duration)
   UpdateBackoff ();
   m_lastBusyStart = Simulator::Now ();
   m_lastBusyDuration = duration;
+  InvalidateAccessGrantStart ();
 }
 
 void
@@ -596,6 +670,7 @@ DcfManager::UpdateBusyDuration (void)
   if (m_lastBusyStart + m_lastBusyDuration > now)
     {
       m_lastBusyDuration = now - m_lastBusyStart;
+      InvalidateAccessGrantStart ();
     }
   DoRestartAccessTimeoutIfNeeded ();
 }
@@ -632,12 +707,10 @@ DcfManager::NotifySwitchingStartNow (Time duration)
     {
       m_lastCtsTimeoutEnd = now;
     }
+  InvalidateAccessGrantStart ();
 
   //Cancel timeout
-  if (m_accessTimeout.IsRunning ())
-    {
-      m_accessTimeout.Cancel ();
-    }
+  CancelAccessTimeout ();
 
   //Reset backoffs
   for (States::iterator i = m_states.begin (); i != m_states.end (); i++)
@@ -657,6 +730,7 @@ DcfManager::NotifySwitchingStartNow (Time duration)
   NS_LOG_DEBUG ("switching start for " << duration);
   m_lastSwitchingStart = Simulator::Now ();
   m_lastSwitchingDuration = duration;
+  InvalidateAccessGrantStart ();
 
 }
 
@@ -666,10 +740,7 @@ DcfManager::NotifySleepNow (void)
   NS_LOG_FUNCTION (this);
   m_sleeping = true;
   //Cancel timeout
-  if (m_accessTimeout.IsRunning ())
-    {
-      m_accessTimeout.Cancel ();
-    }
+  CancelAccessTimeout ();
 
   //Reset backoffs
   for (States::iterator i = m_states.begin (); i != m_states.end (); i++)
@@ -707,6 +778,7 @@ DcfManager::NotifyNavResetNow (Time duration)
   UpdateBackoff ();
   m_lastNavStart = Simulator::Now ();
   m_lastNavDuration = duration;
+  InvalidateAccessGrantStart ();
   /**
    * If the nav reset indicates an end-of-nav which is earlier
    * than the previous end-of-nav, the expected end of backoff
@@ -729,6 +801,7 @@ DcfManager::NotifyNavStartNow (Time duration)
     {
       m_lastNavStart = Simulator::Now ();
       m_lastNavDuration = duration;
+      InvalidateAccessGrantStart ();
     }
 }
 
@@ -738,6 +811,7 @@ DcfManager::NotifyAckTimeoutStartNow (Time duration)
   NS_LOG_FUNCTION (this << duration);
   NS_ASSERT (m_lastAckTimeoutEnd < Simulator::Now ());
   m_lastAckTimeoutEnd = Simulator::Now () + duration;
+  InvalidateAccessGrantStart ();
 }
 
 void
@@ -745,6 +819,7 @@ DcfManager::NotifyAckTimeoutResetNow ()
 {
   NS_LOG_FUNCTION (this);
   m_lastAckTimeoutEnd = Simulator::Now ();
+  InvalidateAccessGrantStart ();
   DoRestartAccessTimeoutIfNeeded ();
 }
 
@@ -753,6 +828,7 @@ DcfManager::NotifyCtsTimeoutStartNow (Time duration)
 {
   NS_LOG_FUNCTION (this << duration);
   m_lastCtsTimeoutEnd = Simulator::Now () + duration;
+  InvalidateAccessGrantStart ();
 }
 
 void
@@ -760,6 +836,7 @@ DcfManager::NotifyCtsTimeoutResetNow ()
 {
   NS_LOG_FUNCTION (this);
   m_lastCtsTimeoutEnd = Simulator::Now ();
+  InvalidateAccessGrantStart ();
   DoRestartAccessTimeoutIfNeeded ();
 }
 
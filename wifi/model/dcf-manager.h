@@ -32,6 +32,7 @@ class WifiPhy;
 class PhyListener;
 class DcfState;
 class MacLow;
+class SharedMediumContention;
 
 /**
  * \brief Manage a set of ns3::DcfState
@@ -51,6 +52,8 @@ class MacLow;
 class DcfManager : public Object
 {
 public:
+  friend class SharedMediumContention;
+
   DcfManager ();
   virtual ~DcfManager ();
 
@@ -67,6 +70,15 @@ public:
    */
   void RemovePhyListener (Ptr<WifiPhy> phy);
   void RemoveOtherPhyListener (Ptr<WifiPhy> phy);
+  /**
+   * \param contention the object collecting the backoff expiries of all the
+   *        stations sharing the medium, or 0 to let this DcfManager
+   *        schedule its own access timeout.
+   *
+   * SetupPhyListener calls this method if a SharedMediumContention object is
+   * aggregated to the channel of the PHY.
+   */
+  void SetSharedMediumContention (Ptr<SharedMediumContention> contention);
   /**
    * Set up listener for MacLow events.
    *
@@ -253,27 +265,20 @@ private:
    * \return the most recent time
    */
   Time MostRecent (Time a, Time b, Time c, Time d, Time e, Time f) const;
-  /**
-   * Return the most recent time.
-   *
-   * \param a
-   * \param b
-   * \param c
-   * \param d
-   * \param e
-   * \param f
-   * \param g
-   *
-   * \return the most recent time
-   */
-  Time MostRecent (Time a, Time b, Time c, Time d, Time e, Time f, Time g) const;
   /**
    * Access will never be granted to the medium _before_
    * the time returned by this method.
    *
+   * The value is cached until one of the times it depends on changes.
+   *
    * \returns the absolute time at which access could start to be granted
    */
   Time GetAccessGrantStart (void) const;
+  /**
+   * Drop the cached access grant start. Must be called whenever one of
+   * the times GetAccessGrantStart depends on is modified.
+   */
+  void InvalidateAccessGrantStart (void);
   /**
    * Return the time when the backoff procedure
    * started for the given DcfState.
@@ -299,6 +304,25 @@ private:
    * (e.g. backoff procedure expired).
    */
   void AccessTimeout (void);
+  /**
+   * \return true if the access timeout is pending
+   */
+  bool IsAccessTimeoutRunning (void) const;
+  /**
+   * \return the delay until the pending access timeout
+   */
+  Time GetAccessTimeoutDelayLeft (void) const;
+  /**
+   * Cancel the pending access timeout, if any.
+   */
+  void CancelAccessTimeout (void);
+  /**
+   * \param delay the delay until the access timeout
+   *
+   * Schedule the access timeout, either directly or through the
+   * SharedMediumContention object.
+   */
+  void ScheduleAccessTimeout (Time delay);
   /**
    * Grant access to DCF
    */
@@ -348,6 +372,9 @@ private:
   Time m_sifs;                  //!< the SIFS time
   PhyListener* m_phyListener;   //!< the phy listener
   PhyListener* m_otherPhyListener;   //!< the phy listener
+  Ptr<SharedMediumContention> m_contention; //!< shared backoff expiries, if enabled
+  mutable Time m_accessGrantStart;      //!< cached value of GetAccessGrantStart
+  mutable bool m_accessGrantStartValid; //!< whether m_accessGrantStart is up to date
 };
 
 } //namespace ns3
@@ -45,6 +45,8 @@ DcfState::DcfState (Ptr<DcaTxop> txop)
     m_cwMax (0),
     m_cw (0),
     m_accessRequested (false),
+    m_accessRequestTime (Seconds (0)),
+    m_accessGrantTime (Seconds (0)),
     m_txop (txop)
 {
   NS_LOG_FUNCTION (this);
@@ -182,11 +184,24 @@ DcfState::IsAccessRequested (void) const
   return m_accessRequested;
 }
 
+Time
+DcfState::GetAccessRequestTime (void) const
+{
+  return m_accessRequestTime;
+}
+
+Time
+DcfState::GetAccessGrantTime (void) const
+{
+  return m_accessGrantTime;
+}
+
 void
 DcfState::NotifyAccessRequested (void)
 {
   NS_LOG_FUNCTION (this);
   m_accessRequested = true;
+  m_accessRequestTime = Simulator::Now ();
 }
 
 void
@@ -195,6 +210,7 @@ DcfState::NotifyAccessGranted (void)
   NS_LOG_FUNCTION (this);
   NS_ASSERT (m_accessRequested);
   m_accessRequested = false;
+  m_accessGrantTime = Simulator::Now ();
   m_txop->NotifyAccessGranted ();
 }
 
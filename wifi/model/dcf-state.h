@@ -141,6 +141,14 @@ public:
    *          has not been granted already, false otherwise.
    */
   bool IsAccessRequested (void) const;
+  /**
+   * \return the time channel access was last requested for this DcfState
+   */
+  Time GetAccessRequestTime (void) const;
+  /**
+   * \return the time channel access was last granted to this DcfState
+   */
+  Time GetAccessGrantTime (void) const;
   void CancelAccessRequested (void);
 
 
@@ -208,6 +216,8 @@ protected:
   uint32_t m_cw;          //!< the current CW
   Time m_txopLimit;       //!< the txop limit time
   bool m_accessRequested; //!< flag whether channel access is already requested
+  Time m_accessRequestTime; //!< the time channel access was last requested
+  Time m_accessGrantTime; //!< the time channel access was last granted
   Ptr<DcaTxop> m_txop;    //!< the DCA TXOP
 };
 
@@ -84,6 +84,7 @@ EdcaTxopN::EdcaTxopN ()
   m_baManager->SetMaxPacketDelay (m_queue->GetMaxDelay ());
   m_baManager->SetTxOkCallback (MakeCallback (&EdcaTxopN::BaTxOk, this));
   m_baManager->SetTxFailedCallback (MakeCallback (&EdcaTxopN::BaTxFailed, this));
+  m_baManager->SetMpduAckedCallback (MakeCallback (&EdcaTxopN::NotifyMpduAcked, this));
 }
 
 EdcaTxopN::~EdcaTxopN ()
@@ -152,7 +153,8 @@ bool
 EdcaTxopN::NeedsAccess (void) const
 {
   NS_LOG_FUNCTION (this);
-  return !m_queue->IsEmpty () || m_currentPacket != 0 || m_baManager->HasPackets ();
+  return !m_queue->IsEmpty () || m_currentPacket != 0 || m_baManager->HasPackets ()
+         || HasMuSourcePacket ();
 }
 
 uint16_t EdcaTxopN::GetNextSequenceNumberFor (WifiMacHeader *hdr)
@@ -185,7 +187,7 @@ EdcaTxopN::NotifyAccessGranted (void)
   m_startTxop = Simulator::Now ();
   if (m_currentPacket == 0)
     {
-      if (m_queue->IsEmpty () && !m_baManager->HasPackets ())
+      if (m_queue->IsEmpty () && !m_baManager->HasPackets () && !HasMuSourcePacket ())
         {
           NS_LOG_DEBUG ("queue is empty");
           return;
@@ -199,23 +201,37 @@ EdcaTxopN::NotifyAccessGranted (void)
       m_currentPacket = m_baManager->GetNextPacket (m_currentHdr);
       if (m_currentPacket == 0)
         {
-          Ptr<const WifiMacQueueItem> item = m_queue->PeekFirstAvailable (m_qosBlockedDestinations);
-          if (item == 0)
+          Ptr<const WifiMacQueueItem> item;
+          if (m_queue->IsEmpty ())
             {
-              NS_LOG_DEBUG ("no available packets in the queue");
-              return;
+              //infocom: per-RU transmitter, pull the frame straight out of the shared SU queue
+              item = DequeueMuSource ();
+              if (item == 0)
+                {
+                  NS_LOG_DEBUG ("no available packets in the queue");
+                  return;
+                }
             }
-          m_currentHdr = item->GetHeader ();
-          m_currentPacketTimestamp = item->GetTimeStamp ();
-          if (m_currentHdr.IsQosData () && !m_currentHdr.GetAddr1 ().IsBroadcast ()
-              && m_stationManager->GetQosSupported (m_currentHdr.GetAddr1 ())
-              && !m_baManager->ExistsAgreement (m_currentHdr.GetAddr1 (), m_currentHdr.GetQosTid ())
-              && SetupBlockAckIfNeeded ())
+          else
             {
-              return;
+              item = m_queue->PeekFirstAvailable (m_qosBlockedDestinations);
+              if (item == 0)
+                {
+                  NS_LOG_DEBUG ("no available packets in the queue");
+                  return;
+                }
+              m_currentHdr = item->GetHeader ();
+              m_currentPacketTimestamp = item->GetTimeStamp ();
+              if (m_currentHdr.IsQosData () && !m_currentHdr.GetAddr1 ().IsBroadcast ()
+                  && m_stationManager->GetQosSupported (m_currentHdr.GetAddr1 ())
+                  && !m_baManager->ExistsAgreement (m_currentHdr.GetAddr1 (), m_currentHdr.GetQosTid ())
+                  && SetupBlockAckIfNeeded ())
+                {
+                  return;
+                }
+              //item = m_queue->DequeueFirstAvailable (m_qosBlockedDestinations); 
+              item = m_queue->Dequeue (); //Hack: I want to dequeue the packet at the head of the queue, because it maybe TFResp
             }
-          //item = m_queue->DequeueFirstAvailable (m_qosBlockedDestinations); 
-          item = m_queue->Dequeue (); //Hack: I want to dequeue the packet at the head of the queue, because it maybe TFResp
           m_currentPacket = item->GetPacket ();
           m_currentHdr = item->GetHeader ();
           m_currentPacketTimestamp = item->GetTimeStamp ();
@@ -543,6 +559,10 @@ EdcaTxopN::GotAck (void)
         {
           m_txOkCallback (m_currentHdr);
         }
+      if (m_currentHdr.IsData ())
+        {
+          NotifyMpduAcked (m_currentPacketTimestamp);
+        }
 
       if (m_currentHdr.IsAction ())
         {
@@ -780,7 +800,7 @@ EdcaTxopN::RestartAccessIfNeeded (void)
 {
   NS_LOG_FUNCTION (this);
   if ((m_currentPacket != 0
-       || !m_queue->IsEmpty () || m_baManager->HasPackets ())
+       || !m_queue->IsEmpty () || m_baManager->HasPackets () || HasMuSourcePacket ())
       && !m_dcf->IsAccessRequested ())
     {
       Ptr<const Packet> packet;
@@ -821,7 +841,7 @@ EdcaTxopN::StartAccessIfNeeded (void)
 {
   //NS_LOG_FUNCTION (this);
   if (m_currentPacket == 0
-      && (!m_queue->IsEmpty () || m_baManager->HasPackets ())
+      && (!m_queue->IsEmpty () || m_baManager->HasPackets () || HasMuSourcePacket ())
       && !m_dcf->IsAccessRequested ())
     {
       Ptr<const Packet> packet;
@@ -546,7 +546,6 @@ private:
   Ptr<BlockAckManager> m_baManager;                     //!< the Block ACK manager
   uint8_t m_blockAckThreshold;                      //!< the Block ACK threshold
   BlockAckType m_blockAckType;                      //!< the Block ACK type
-  Time m_currentPacketTimestamp;                    //!< the current packet timestamp
   uint16_t m_blockAckInactivityTimeout;             //!< the Block ACK inactivity timeout
   Bar m_currentBar;                                 //!< the current BAR
   Time m_startTxop;                                 //!< the start TXOP time
@@ -0,0 +1,340 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "he-ru-wifi-manager.h"
+#include "wifi-phy.h"
+#include "wifi-utils.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+/**
+ * \brief hold per-remote-station state for HE RU Wifi manager.
+ *
+ * This struct extends from WifiRemoteStation struct to hold additional
+ * information required by the HE RU Wifi manager
+ */
+struct HeRuWifiRemoteStation : public WifiRemoteStation
+{
+  HeRuStationEstimates::Estimate *m_estimate; //!< shared estimate of the station, 0 until first used
+  double m_lastSnrCached;                     //!< SNR most recently used to select a rate
+  bool m_lastPerHigh;                         //!< whether the PER was above MaxPer when selecting the rate
+  WifiMode m_lastMode;                        //!< Mode most recently used to the remote station
+  uint8_t m_nss;                              //!< NSS most recently used to the remote station
+};
+
+NS_OBJECT_ENSURE_REGISTERED (HeRuWifiManager);
+
+NS_LOG_COMPONENT_DEFINE ("HeRuWifiManager");
+
+HeRuStationEstimates::Estimate *
+HeRuStationEstimates::Lookup (Mac48Address address)
+{
+  Estimates::iterator it = m_estimates.find (address);
+  if (it == m_estimates.end ())
+    {
+      Estimate estimate;
+      estimate.snr = 0.0;
+      estimate.per = 0.0;
+      estimate.nSamples = 0;
+      it = m_estimates.insert (std::make_pair (address, estimate)).first;
+    }
+  return &it->second;
+}
+
+TypeId
+HeRuWifiManager::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::HeRuWifiManager")
+    .SetParent<WifiRemoteStationManager> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<HeRuWifiManager> ()
+    .AddAttribute ("BerThreshold",
+                   "The maximum Bit Error Rate acceptable at any MCS",
+                   DoubleValue (1e-5),
+                   MakeDoubleAccessor (&HeRuWifiManager::m_ber),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("Alpha",
+                   "Weight of a new sample in the SNR and PER moving averages",
+                   DoubleValue (0.25),
+                   MakeDoubleAccessor (&HeRuWifiManager::m_alpha),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("MaxPer",
+                   "Averaged MPDU error rate above which the MCS below the one matching the SNR is used",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&HeRuWifiManager::m_maxPer),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddTraceSource ("Rate",
+                     "Traced value for rate changes (b/s)",
+                     MakeTraceSourceAccessor (&HeRuWifiManager::m_currentRate),
+                     "ns3::TracedValueCallback::Uint64")
+  ;
+  return tid;
+}
+
+HeRuWifiManager::HeRuWifiManager ()
+  : m_estimates (Create<HeRuStationEstimates> ()),
+    m_currentRate (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+HeRuWifiManager::~HeRuWifiManager ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+HeRuWifiManager::ShareEstimates (Ptr<HeRuWifiManager> manager)
+{
+  NS_LOG_FUNCTION (this << manager);
+  m_estimates = manager->m_estimates;
+}
+
+void
+HeRuWifiManager::DoInitialize ()
+{
+  NS_LOG_FUNCTION (this);
+  m_heMcs.clear ();
+  m_thresholds.clear ();
+  uint8_t nMcs = GetPhy ()->GetNMcs ();
+  for (uint8_t i = 0; i < nMcs; i++)
+    {
+      WifiMode mode = GetPhy ()->GetMcs (i);
+      if (mode.GetModulationClass () == WIFI_MOD_CLASS_HE)
+        {
+          m_heMcs.push_back (mode);
+        }
+    }
+  WifiTxVector txVector;
+  txVector.SetChannelWidth (GetPhy ()->GetChannelWidth ());
+  txVector.SetGuardInterval (GetPhy ()->GetGuardInterval ().GetNanoSeconds ());
+  //infocom: thresholds of the RU managers are computed for the RU of their PHY
+  txVector.SetMuMode (GetPhy ()->GetMuMode ());
+  txVector.SetRuBits (GetPhy ()->GetRuBits ());
+  uint8_t maxNss = GetPhy ()->GetMaxSupportedTxSpatialStreams ();
+  for (uint8_t nss = 1; nss <= maxNss; nss++)
+    {
+      txVector.SetNss (nss);
+      m_thresholds.push_back (std::vector<double> ());
+      for (std::vector<WifiMode>::const_iterator i = m_heMcs.begin (); i != m_heMcs.end (); i++)
+        {
+          txVector.SetMode (*i);
+          double snr = GetPhy ()->CalculateSnr (txVector, m_ber);
+          NS_LOG_DEBUG ("Initialize, adding mode = " << i->GetUniqueName () <<
+                        " nss " << (uint16_t) nss << " threshold " << snr);
+          m_thresholds.back ().push_back (snr);
+        }
+    }
+}
+
+WifiRemoteStation *
+HeRuWifiManager::DoCreateStation (void) const
+{
+  NS_LOG_FUNCTION (this);
+  HeRuWifiRemoteStation *station = new HeRuWifiRemoteStation ();
+  station->m_estimate = 0;
+  station->m_lastSnrCached = -1.0;
+  station->m_lastPerHigh = false;
+  station->m_lastMode = GetDefaultMode ();
+  station->m_nss = 1;
+  return station;
+}
+
+HeRuStationEstimates::Estimate *
+HeRuWifiManager::GetEstimate (WifiRemoteStation *st) const
+{
+  HeRuWifiRemoteStation *station = (HeRuWifiRemoteStation *)st;
+  if (station->m_estimate == 0)
+    {
+      station->m_estimate = m_estimates->Lookup (GetAddress (station));
+    }
+  return station->m_estimate;
+}
+
+void
+HeRuWifiManager::UpdateSnr (WifiRemoteStation *station, double snr)
+{
+  NS_LOG_FUNCTION (this << station << snr);
+  if (snr == 0)
+    {
+      NS_LOG_WARN ("DataSnr reported to be zero; not saving this report.");
+      return;
+    }
+  HeRuStationEstimates::Estimate *estimate = GetEstimate (station);
+  if (estimate->nSamples == 0)
+    {
+      estimate->snr = snr;
+    }
+  else
+    {
+      estimate->snr = m_alpha * snr + (1 - m_alpha) * estimate->snr;
+    }
+  estimate->nSamples++;
+}
+
+void
+HeRuWifiManager::UpdatePer (WifiRemoteStation *station, uint8_t nSuccessfulMpdus, uint8_t nFailedMpdus)
+{
+  NS_LOG_FUNCTION (this << station << (uint16_t)nSuccessfulMpdus << (uint16_t)nFailedMpdus);
+  uint16_t nMpdus = nSuccessfulMpdus + nFailedMpdus;
+  if (nMpdus == 0)
+    {
+      return;
+    }
+  HeRuStationEstimates::Estimate *estimate = GetEstimate (station);
+  estimate->per = m_alpha * nFailedMpdus / nMpdus + (1 - m_alpha) * estimate->per;
+}
+
+void
+HeRuWifiManager::DoReportRxOk (WifiRemoteStation *station,
+                               double rxSnr, WifiMode txMode)
+{
+}
+
+void
+HeRuWifiManager::DoReportRtsFailed (WifiRemoteStation *station)
+{
+}
+
+void
+HeRuWifiManager::DoReportDataFailed (WifiRemoteStation *station)
+{
+  NS_LOG_FUNCTION (this << station);
+  UpdatePer (station, 0, 1);
+}
+
+void
+HeRuWifiManager::DoReportRtsOk (WifiRemoteStation *station,
+                                double ctsSnr, WifiMode ctsMode, double rtsSnr)
+{
+  NS_LOG_FUNCTION (this << station << ctsSnr << ctsMode.GetUniqueName () << rtsSnr);
+  UpdateSnr (station, rtsSnr);
+}
+
+void
+HeRuWifiManager::DoReportDataOk (WifiRemoteStation *station,
+                                 double ackSnr, WifiMode ackMode, double dataSnr)
+{
+  NS_LOG_FUNCTION (this << station << ackSnr << ackMode.GetUniqueName () << dataSnr);
+  UpdateSnr (station, dataSnr);
+  UpdatePer (station, 1, 0);
+}
+
+void
+HeRuWifiManager::DoReportAmpduTxStatus (WifiRemoteStation *station, uint8_t nSuccessfulMpdus, uint8_t nFailedMpdus, double rxSnr, double dataSnr)
+{
+  NS_LOG_FUNCTION (this << station << (uint16_t)nSuccessfulMpdus << (uint16_t)nFailedMpdus << rxSnr << dataSnr);
+  UpdateSnr (station, dataSnr);
+  UpdatePer (station, nSuccessfulMpdus, nFailedMpdus);
+}
+
+void
+HeRuWifiManager::DoReportFinalRtsFailed (WifiRemoteStation *station)
+{
+}
+
+void
+HeRuWifiManager::DoReportFinalDataFailed (WifiRemoteStation *station)
+{
+}
+
+WifiTxVector
+HeRuWifiManager::DoGetDataTxVector (WifiRemoteStation *st)
+{
+  NS_LOG_FUNCTION (this << st);
+  HeRuWifiRemoteStation *station = (HeRuWifiRemoteStation *)st;
+  uint8_t channelWidth = std::min (GetChannelWidth (station), GetPhy ()->GetChannelWidth ());
+  //infocom: the RU managers are not told the capabilities of the peers,
+  //but only HE stations are served on RUs
+  if (!HasHeSupported () || m_heMcs.empty ()
+      || (!GetHeSupported (station) && !GetPhy ()->GetMuMode ()))
+    {
+      WifiMode mode = GetDefaultMode ();
+      return WifiTxVector (mode, GetDefaultTxPowerLevel (), GetLongRetryCount (station), GetPreambleForTransmission (mode, GetAddress (station)), ConvertGuardIntervalToNanoSeconds (mode, GetShortGuardInterval (station), NanoSeconds (GetGuardInterval (station))), GetNumberOfAntennas (), 1, 0, channelWidth, GetAggregation (station), false);
+    }
+
+  uint16_t guardInterval = std::max (GetGuardInterval (station), static_cast<uint16_t> (GetPhy ()->GetGuardInterval ().GetNanoSeconds ()));
+  HeRuStationEstimates::Estimate *estimate = GetEstimate (station);
+  bool perHigh = estimate->per > m_maxPer;
+  if (estimate->snr != station->m_lastSnrCached || perHigh != station->m_lastPerHigh)
+    {
+      //We search the MCS with the highest snr threshold possible which
+      //is smaller than the averaged snr, and step down once if too many
+      //MPDUs are lost at that snr.
+      WifiTxVector txVector;
+      txVector.SetChannelWidth (channelWidth);
+      txVector.SetGuardInterval (guardInterval);
+      double maxThreshold = 0.0;
+      uint32_t selected = 0;
+      uint8_t selectedNss = 1;
+      uint8_t maxNss = std::min (GetPhy ()->GetMaxSupportedTxSpatialStreams (), GetNumberOfSupportedStreams (station));
+      for (uint8_t nss = 1; nss <= maxNss; nss++)
+        {
+          txVector.SetNss (nss);
+          for (uint32_t i = 0; i < m_heMcs.size (); i++)
+            {
+              txVector.SetMode (m_heMcs[i]);
+              if (WifiPhy::IsValidTxVector (txVector) == false)
+                {
+                  continue;
+                }
+              double threshold = m_thresholds[nss - 1][i];
+              if (threshold > maxThreshold && threshold < estimate->snr)
+                {
+                  maxThreshold = threshold;
+                  selected = i;
+                  selectedNss = nss;
+                }
+            }
+        }
+      if (perHigh && selected > 0)
+        {
+          selected--;
+        }
+      NS_LOG_DEBUG ("Updating cached values for station to " << m_heMcs[selected].GetUniqueName () <<
+                    " nss " << (uint16_t) selectedNss << " snr " << estimate->snr << " per " << estimate->per);
+      station->m_lastSnrCached = estimate->snr;
+      station->m_lastPerHigh = perHigh;
+      station->m_lastMode = m_heMcs[selected];
+      station->m_nss = selectedNss;
+    }
+  WifiMode mode = station->m_lastMode;
+  if (m_currentRate != mode.GetDataRate (channelWidth, guardInterval, station->m_nss))
+    {
+      NS_LOG_DEBUG ("New datarate: " << mode.GetDataRate (channelWidth, guardInterval, station->m_nss));
+      m_currentRate = mode.GetDataRate (channelWidth, guardInterval, station->m_nss);
+    }
+  return WifiTxVector (mode, GetDefaultTxPowerLevel (), GetLongRetryCount (station), GetPreambleForTransmission (mode, GetAddress (station)), guardInterval, GetNumberOfAntennas (), station->m_nss, 0, channelWidth, GetAggregation (station), false);
+}
+
+WifiTxVector
+HeRuWifiManager::DoGetRtsTxVector (WifiRemoteStation *st)
+{
+  NS_LOG_FUNCTION (this << st);
+  //RTS is sent in a legacy frame at the default mode
+  WifiMode mode = GetDefaultMode ();
+  return WifiTxVector (mode, GetDefaultTxPowerLevel (), GetShortRetryCount (st), GetPreambleForTransmission (mode, GetAddress (st)), 800, GetNumberOfAntennas (), 1, 0, 20, GetAggregation (st), false);
+}
+
+bool
+HeRuWifiManager::IsLowLatency (void) const
+{
+  return true;
+}
+
+} //namespace ns3
@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef HE_RU_WIFI_MANAGER_H
+#define HE_RU_WIFI_MANAGER_H
+
+#include "ns3/traced-value.h"
+#include "ns3/simple-ref-count.h"
+#include "wifi-remote-station-manager.h"
+#include <map>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief SNR and PER estimates of the remote stations of a device
+ *
+ * The estimates are shared by the station managers of the full channel
+ * and of all the RUs of a device, so that every transmission to a
+ * station, whatever the RU it uses, refines the same estimate.
+ */
+class HeRuStationEstimates : public SimpleRefCount<HeRuStationEstimates>
+{
+public:
+  /// estimate of a remote station
+  struct Estimate
+  {
+    double snr;        //!< averaged SNR of the data frames (linear)
+    double per;        //!< averaged MPDU error rate
+    uint32_t nSamples; //!< number of SNR samples averaged so far
+  };
+
+  /**
+   * \param address the address of the remote station
+   * \return the estimate of the station, created empty if needed
+   */
+  Estimate * Lookup (Mac48Address address);
+
+private:
+  /// estimates, per remote station
+  typedef std::map<Mac48Address, Estimate> Estimates;
+
+  Estimates m_estimates; //!< estimates, per remote station
+};
+
+/**
+ * \brief SNR based HE rate control for the full channel and the RUs
+ * \ingroup wifi
+ *
+ * infocom: a device has one station manager for the full channel and one
+ * per RU. With per-manager rate control, each RU would learn the link to
+ * a station on its own. This manager keeps a single SNR and PER estimate
+ * per station, shared by all the managers of the device (see
+ * ShareEstimates), and fed by the data and A-MPDU reports of any of them.
+ *
+ * Each manager maps the estimate to the HE MCS with the highest SNR
+ * threshold below the averaged SNR, where thresholds are computed, as in
+ * IdealWifiManager, from a target BER and the error rate model of its own
+ * PHY, hence for the RU size of that PHY. If the averaged PER exceeds
+ * MaxPer, the MCS just below is used instead.
+ *
+ * Stations that do not support HE are served at the default mode.
+ */
+class HeRuWifiManager : public WifiRemoteStationManager
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  HeRuWifiManager ();
+  virtual ~HeRuWifiManager ();
+
+  /**
+   * \param manager the manager whose station estimates are used
+   *
+   * Use the station estimates of <i>manager</i> instead of the ones of
+   * this manager. Must be called before any station is created.
+   */
+  void ShareEstimates (Ptr<HeRuWifiManager> manager);
+
+
+private:
+  //overriden from base class
+  void DoInitialize (void);
+  WifiRemoteStation* DoCreateStation (void) const;
+  void DoReportRxOk (WifiRemoteStation *station,
+                     double rxSnr, WifiMode txMode);
+  void DoReportRtsFailed (WifiRemoteStation *station);
+  void DoReportDataFailed (WifiRemoteStation *station);
+  void DoReportRtsOk (WifiRemoteStation *station,
+                      double ctsSnr, WifiMode ctsMode, double rtsSnr);
+  void DoReportDataOk (WifiRemoteStation *station,
+                       double ackSnr, WifiMode ackMode, double dataSnr);
+  void DoReportAmpduTxStatus (WifiRemoteStation *station,
+                              uint8_t nSuccessfulMpdus, uint8_t nFailedMpdus,
+                              double rxSnr, double dataSnr);
+  void DoReportFinalRtsFailed (WifiRemoteStation *station);
+  void DoReportFinalDataFailed (WifiRemoteStation *station);
+  WifiTxVector DoGetDataTxVector (WifiRemoteStation *station);
+  WifiTxVector DoGetRtsTxVector (WifiRemoteStation *station);
+  bool IsLowLatency (void) const;
+
+  /**
+   * \param station the remote station
+   * \return the shared estimate of the station
+   */
+  HeRuStationEstimates::Estimate * GetEstimate (WifiRemoteStation *station) const;
+  /**
+   * Average an SNR sample into the estimate of a station.
+   *
+   * \param station the remote station
+   * \param snr the SNR of the data frame (linear)
+   */
+  void UpdateSnr (WifiRemoteStation *station, double snr);
+  /**
+   * Average MPDU outcomes into the estimate of a station.
+   *
+   * \param station the remote station
+   * \param nSuccessfulMpdus the number of MPDUs received
+   * \param nFailedMpdus the number of MPDUs lost
+   */
+  void UpdatePer (WifiRemoteStation *station, uint8_t nSuccessfulMpdus, uint8_t nFailedMpdus);
+
+  /// HE MCSs of the PHY, in increasing order
+  std::vector<WifiMode> m_heMcs;
+  /// minimum SNR of each HE MCS, indexed by NSS - 1 and position in m_heMcs
+  std::vector<std::vector<double> > m_thresholds;
+
+  Ptr<HeRuStationEstimates> m_estimates; //!< station estimates, possibly shared
+  double m_ber;                          //!< The maximum Bit Error Rate acceptable at any MCS
+  double m_alpha;                        //!< Weight of the new samples in the averages
+  double m_maxPer;                       //!< PER above which the next lower MCS is used
+
+  TracedValue<uint64_t> m_currentRate; //!< Trace rate changes
+};
+
+} //namespace ns3
+
+#endif /* HE_RU_WIFI_MANAGER_H */
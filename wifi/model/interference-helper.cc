@@ -23,6 +23,7 @@
 #include "wifi-phy.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/hot-path-profiler.h"
 #include <algorithm>
 
 namespace ns3 {
@@ -830,6 +831,7 @@ InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event>
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<InterferenceHelper::Event> event)
 {
+  NS_PROFILE_FUNCTION ("InterferenceHelper::CalculatePlcpPayloadSnrPer");
   NiChanges ni;
   double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
   double snr = CalculateSnr (event->GetRxPowerW (),
@@ -30,6 +30,7 @@
 #include "ampdu-tag.h"
 #include "wifi-mac-queue.h"
 #include "ampdu-subframe-header.h"
+#include "ns3/hot-path-profiler.h"
 
 #undef NS_LOG_APPEND_CONTEXT
 #define NS_LOG_APPEND_CONTEXT std::clog << "[mac=" << m_self << "] "
@@ -607,6 +608,24 @@ MacLow::SetRxCallback (Callback<void, Ptr<Packet>, const WifiMacHeader *> callba
   m_rxCallback = callback;
 }
 
+void
+MacLow::SetCounters (Ptr<WifiDeviceCounters> counters)
+{
+  m_counters = counters;
+}
+
+Time
+MacLow::GetTransmissionStart (void) const
+{
+  return m_txStart;
+}
+
+uint32_t
+MacLow::GetCountersRu (void) const
+{
+  return m_phy->GetMuMode () ? m_phy->GetRuBits () : WifiDeviceCounters::FULL_CHANNEL;
+}
+
 void
 MacLow::RegisterDcf (Ptr<DcfManager> dcf)
 {
@@ -641,6 +660,26 @@ MacLow::CalculateTfBeaconDuration (Ptr<const Packet> packet, const WifiMacHeader
   return m_phy->CalculateTxDuration (GetSize(packet, &hdr, false), tfBeaconTxVector, m_phy->GetFrequency ()); 
 }
 
+Time
+MacLow::CalculateTfBeaconDuration (uint32_t payloadSize, const WifiMacHeader &hdr)
+{
+  NS_ASSERT (hdr.GetAddr1 ().IsGroup ()); // the TX vector of a group frame does not depend on the packet
+  WifiTxVector tfBeaconTxVector = m_stationManager->GetDataTxVector (hdr.GetAddr1 (), &hdr, 0);
+  tfBeaconTxVector.SetMuMode (0);
+  tfBeaconTxVector.SetRuBits (1);
+  return m_phy->CalculateTxDuration (GetSize (payloadSize, &hdr, false), tfBeaconTxVector, m_phy->GetFrequency ());
+}
+
+uint32_t
+MacLow::CalculateMuPayloadDuration (Ptr<const WifiMacQueueItem> item) const
+{
+  WifiMacHeader hdr = item->GetHeader ();
+  WifiTxVector txVector = GetDataTxVector (item->GetPacket (), &hdr);
+  txVector.SetMuMode (1);
+  txVector.SetRuBits (0);
+  return m_phy->CalculateTxDuration (GetSize (item->GetPacket (), &hdr, false), txVector, m_phy->GetFrequency ()).GetMicroSeconds ();
+}
+
 uint32_t
 MacLow::CalculateStaPayloadDuration (void)
 {
@@ -648,22 +687,21 @@ MacLow::CalculateStaPayloadDuration (void)
   NS_ASSERT (edcaIt != m_edca.end ());
   Ptr<WifiMacQueue> queue = edcaIt->second->GetQueue ();
   Ptr<const WifiMacQueueItem> item = queue->Peek ();
+  if (item == 0 && edcaIt->second->GetMuSource () != 0)
+   {
+     item = edcaIt->second->GetMuSource ()->Peek (); //infocom: the STA's data frames wait in the SU queue shared with this RU
+   }
   if (item) // Packet found
    {
-     Ptr<Packet> p = item->GetPacket ()->Copy ();
-     WifiMacHeader hdr = item->GetHeader ();
-     WifiTxVector txVector = GetDataTxVector (p, &hdr); 
-     txVector.SetMuMode (1);
-     txVector.SetRuBits (0);
-     return m_phy->CalculateTxDuration (GetSize (p, &hdr, false), txVector, m_phy->GetFrequency ()).GetMicroSeconds ();
-   }  
+     return CalculateMuPayloadDuration (item);
+   }
   else // No packet found
    {
      return 0;
    }
 }
 
-uint32_t 
+uint32_t
 MacLow::CalculateApPayloadDuration (void)
 {
   std::map<AcIndex, Ptr<EdcaTxopN> >::const_iterator edcaIt = m_edca.find (AC_BE); //Ideally, I must get tid from pkt and header, and map tid to ac
@@ -671,14 +709,26 @@ MacLow::CalculateApPayloadDuration (void)
   Ptr<WifiMacQueue> queue = edcaIt->second->GetQueue ();
   Ptr<const WifiMacQueueItem> item = queue->Peek ();
   if (item) // Packet found
-   { 
-     Ptr<Packet> p = item->GetPacket ()->Copy ();
-     WifiMacHeader hdr = item->GetHeader ();
-     WifiTxVector txVector = GetDataTxVector (p, &hdr); 
-     txVector.SetMuMode (1);
-     txVector.SetRuBits (0);
-     return m_phy->CalculateTxDuration (GetSize (p, &hdr, false), txVector, m_phy->GetFrequency ()).GetMicroSeconds ();
-   }  
+   {
+     return CalculateMuPayloadDuration (item);
+   }
+  else // No packet found
+   {
+     return 0;
+   }
+}
+
+uint32_t
+MacLow::CalculateApPayloadDuration (Mac48Address to)
+{
+  std::map<AcIndex, Ptr<EdcaTxopN> >::const_iterator edcaIt = m_edca.find (AC_BE);
+  NS_ASSERT (edcaIt != m_edca.end ());
+  Ptr<WifiMacQueue> queue = edcaIt->second->GetQueue ();
+  Ptr<const WifiMacQueueItem> item = queue->PeekByAddress (WifiMacHeader::ADDR1, to);
+  if (item) // Packet found
+   {
+     return CalculateMuPayloadDuration (item);
+   }
   else // No packet found
    {
      return 0;
@@ -712,6 +762,7 @@ MacLow::StartTransmission (Ptr<const Packet> packet,
   m_currentPacket->RemovePacketTag (priorityTag);
   m_currentHdr = *hdr;
   m_currentDca = dca;
+  m_txStart = Simulator::Now ();
   CancelAllEvents ();
   m_txParams = params;
   m_currentTxVector = GetDataTxVector (m_currentPacket, &m_currentHdr);
@@ -883,6 +934,7 @@ void
 MacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, WifiTxVector txVector, bool ampduSubframe)
 {
   NS_LOG_FUNCTION (this << packet << rxSnr << txVector.GetMode () << txVector.GetPreambleType () << Simulator::Now ().GetMicroSeconds ());
+  NS_PROFILE_FUNCTION ("MacLow::ReceiveOk");
   /* A packet is received from the PHY.
    * When we have handled this packet,
    * we handle any packet present in the
@@ -1100,6 +1152,10 @@ MacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, WifiTxVector txVector, bool
     {
       m_stationManager->ReportRxOk (hdr.GetAddr2 (), &hdr,
                                     rxSnr, txVector.GetMode ());
+      if (m_counters != 0 && hdr.IsData ())
+        {
+          m_counters->NotifyRxMpdu (GetCountersRu (), hdr, hdr.GetSize () + packet->GetSize ());
+        }
       if (hdr.IsQosData () && ReceiveMpdu (packet, hdr))
         {
           /* From section 9.10.4 in IEEE 802.11:
@@ -1330,16 +1386,22 @@ MacLow::GetCtsSize (void)
 
 uint32_t
 MacLow::GetSize (Ptr<const Packet> packet, const WifiMacHeader *hdr, bool isAmpdu)
+{
+  return GetSize (packet->GetSize (), hdr, isAmpdu);
+}
+
+uint32_t
+MacLow::GetSize (uint32_t payloadSize, const WifiMacHeader *hdr, bool isAmpdu)
 {
   uint32_t size;
   WifiMacTrailer fcs;
   if (isAmpdu)
     {
-      size = packet->GetSize ();
+      size = payloadSize;
     }
   else
     {
-      size = packet->GetSize () + hdr->GetSize () + fcs.GetSerializedSize ();
+      size = payloadSize + hdr->GetSize () + fcs.GetSerializedSize ();
     }
   return size;
 }
@@ -1448,8 +1510,7 @@ MacLow::CalculateOverallTxFragmentTime (Ptr<const Packet> packet,
       txTime += Time (GetSifs () * 2);
     }
   WifiTxVector dataTxVector = GetDataTxVector (packet, hdr);
-  Ptr<const Packet> fragment = Create<Packet> (fragmentSize);
-  uint32_t dataSize = GetSize (fragment, hdr, m_ampdu);
+  uint32_t dataSize = GetSize (fragmentSize, hdr, m_ampdu);
   if (m_phy->GetMuMode ())
    {  
      dataTxVector.SetMuMode (m_phy->GetMuMode ());
@@ -1620,6 +1681,10 @@ MacLow::ForwardDown (Ptr<const Packet> packet, const WifiMacHeader* hdr, WifiTxV
                 ", seq=0x" << std::hex << m_currentHdr.GetSequenceControl () << std::dec);
   if (!m_ampdu || hdr->IsAck () || hdr->IsRts () || hdr->IsBlockAck () || hdr->IsMgt ())
     {
+      if (m_counters != 0 && hdr->IsData ())
+        {
+          m_counters->NotifyTxMpdu (GetCountersRu (), *hdr, packet->GetSize ());
+        }
      m_phy->SendPacket (packet, txVector);
     }
   else
@@ -1656,6 +1721,10 @@ MacLow::ForwardDown (Ptr<const Packet> packet, const WifiMacHeader* hdr, WifiTxV
         {
           txVector.SetAggregation (true);
         }
+      if (m_counters != 0)
+        {
+          m_counters->NotifyAmpdu (queueSize);
+        }
       for (; queueSize > 0; queueSize--)
         {
           dequeuedItem = m_aggregateQueue[GetTid (packet, *hdr)]->Dequeue ();
@@ -1664,6 +1733,10 @@ MacLow::ForwardDown (Ptr<const Packet> packet, const WifiMacHeader* hdr, WifiTxV
           newHdr.SetDuration (hdr->GetDuration ());
           newPacket->AddHeader (newHdr);
           AddWifiMacTrailer (newPacket);
+          if (m_counters != 0)
+            {
+              m_counters->NotifyTxMpdu (GetCountersRu (), newHdr, newPacket->GetSize ());
+            }
           if (queueSize == 1)
             {
               last = true;
@@ -2445,17 +2518,7 @@ MacLow::StoreMpduIfNeeded (Ptr<Packet> packet, WifiMacHeader hdr)
     {
       WifiMacTrailer fcs;
       packet->RemoveTrailer (fcs);
-      BufferedPacket bufferedPacket (packet, hdr);
-
-      uint16_t endSequence = ((*it).second.first.GetStartingSequence () + 2047) % 4096;
-      uint16_t mappedSeqControl = QosUtilsMapSeqControlToUniqueInteger (hdr.GetSequenceControl (), endSequence);
-
-      BufferedPacketI i = (*it).second.second.begin ();
-      for (; i != (*it).second.second.end ()
-           && QosUtilsMapSeqControlToUniqueInteger ((*i).second.GetSequenceControl (), endSequence) < mappedSeqControl; i++)
-        {
-        }
-      (*it).second.second.insert (i, bufferedPacket);
+      (*it).second.second.Store (packet, hdr);
 
       //Update block ack cache
       BlockAckCachesI j = m_bAckCaches.find (std::make_pair (hdr.GetAddr2 (), hdr.GetQosTid ()));
@@ -2486,9 +2549,8 @@ MacLow::CreateBlockAckAgreement (const MgtAddBaResponseHeader *respHdr, Mac48Add
   agreement.SetTimeout (respHdr->GetTimeout ());
   agreement.SetStartingSequence (startingSeq);
 
-  std::list<BufferedPacket> buffer (0);
   AgreementKey key (originator, respHdr->GetTid ());
-  AgreementValue value (agreement, buffer);
+  AgreementValue value (agreement, ReorderBuffer ());
   m_bAckAgreements.insert (std::make_pair (key, value));
 
   BlockAckCache cache;
@@ -2531,60 +2593,10 @@ MacLow::RxCompleteBufferedPacketsWithSmallerSequence (uint16_t seq, Mac48Address
   AgreementsI it = m_bAckAgreements.find (std::make_pair (originator, tid));
   if (it != m_bAckAgreements.end ())
     {
-      uint16_t endSequence = ((*it).second.first.GetStartingSequence () + 2047) % 4096;
-      uint16_t mappedStart = QosUtilsMapSeqControlToUniqueInteger (seq, endSequence);
-      BufferedPacketI last = (*it).second.second.begin ();
-      uint16_t guard = 0;
-      if (last != (*it).second.second.end ())
-        {
-          guard = (*it).second.second.begin ()->second.GetSequenceControl ();
-        }
-      BufferedPacketI i = (*it).second.second.begin ();
-      for (; i != (*it).second.second.end ()
-           && QosUtilsMapSeqControlToUniqueInteger ((*i).second.GetSequenceControl (), endSequence) < mappedStart; )
-        {
-          if (guard == (*i).second.GetSequenceControl ())
-            {
-              if (!(*i).second.IsMoreFragments ())
-                {
-                  while (last != i)
-                    {
-                      m_rxCallback ((*last).first, &(*last).second);
-                      last++;
-                    }
-                  m_rxCallback ((*last).first, &(*last).second);
-                  last++;
-                  /* go to next packet */
-                  while (i != (*it).second.second.end () && guard == (*i).second.GetSequenceControl ())
-                    {
-                      i++;
-                    }
-                  if (i != (*it).second.second.end ())
-                    {
-                      guard = (*i).second.GetSequenceControl ();
-                      last = i;
-                    }
-                }
-              else
-                {
-                  guard++;
-                }
-            }
-          else
-            {
-              /* go to next packet */
-              while (i != (*it).second.second.end () && guard == (*i).second.GetSequenceControl ())
-                {
-                  i++;
-                }
-              if (i != (*it).second.second.end ())
-                {
-                  guard = (*i).second.GetSequenceControl ();
-                  last = i;
-                }
-            }
-        }
-      (*it).second.second.erase ((*it).second.second.begin (), i);
+      //Sequence numbers are compared circularly, the oldest one being 2048
+      //before the starting sequence of the agreement
+      uint16_t oldest = ((*it).second.first.GetStartingSequence () + 2048) % 4096;
+      (*it).second.second.ForwardRange (oldest, (seq >> 4) & 0x0fff, m_rxCallback);
     }
 }
 
@@ -2594,29 +2606,120 @@ MacLow::RxCompleteBufferedPacketsUntilFirstLost (Mac48Address originator, uint8_
   AgreementsI it = m_bAckAgreements.find (std::make_pair (originator, tid));
   if (it != m_bAckAgreements.end ())
     {
-      uint16_t guard = (*it).second.first.GetStartingSequenceControl ();
-      BufferedPacketI lastComplete = (*it).second.second.begin ();
-      BufferedPacketI i = (*it).second.second.begin ();
-      for (; i != (*it).second.second.end () && guard == (*i).second.GetSequenceControl (); i++)
+      uint16_t guard = (*it).second.second.ForwardUntilFirstLost ((*it).second.first.GetStartingSequence (), m_rxCallback);
+      (*it).second.first.SetStartingSequenceControl (guard);
+    }
+}
+
+MacLow::ReorderBuffer::ReorderBuffer ()
+{
+  memset (m_slots, 0, sizeof (m_slots));
+}
+
+void
+MacLow::ReorderBuffer::Store (Ptr<Packet> packet, const WifiMacHeader &hdr)
+{
+  uint16_t seq = hdr.GetSequenceNumber ();
+  uint8_t fragment = hdr.GetFragmentNumber ();
+  uint32_t index;
+  if (m_freeEntries.empty ())
+    {
+      index = m_entries.size ();
+      m_entries.push_back (Entry ());
+    }
+  else
+    {
+      index = m_freeEntries.back ();
+      m_freeEntries.pop_back ();
+    }
+  uint32_t *link = &m_slots[seq];
+  while (*link != 0 && m_entries[*link - 1].mpdu.second.GetFragmentNumber () < fragment)
+    {
+      link = &m_entries[*link - 1].next;
+    }
+  if (*link != 0 && m_entries[*link - 1].mpdu.second.GetFragmentNumber () == fragment)
+    {
+      NS_LOG_DEBUG ("Drop duplicate of buffered MPDU seq=" << seq << " frag=" << (uint16_t) fragment);
+      m_freeEntries.push_back (index);
+      return;
+    }
+  m_entries[index].mpdu = BufferedPacket (packet, hdr);
+  m_entries[index].next = *link;
+  *link = index + 1;
+  m_buffered.Set (seq);
+  if (GetContiguousFragments (seq).second)
+    {
+      m_complete.Set (seq);
+    }
+}
+
+uint16_t
+MacLow::ReorderBuffer::ForwardUntilFirstLost (uint16_t seq, MacLowRxCallback rxCallback)
+{
+  uint16_t firstLost = m_complete.FindFirstClear (seq);
+  for (uint16_t i = seq; i != firstLost; i = (i + 1) % 4096)
+    {
+      Release (i, rxCallback);
+    }
+  return (firstLost << 4) | (GetContiguousFragments (firstLost).first & 0x000f);
+}
+
+void
+MacLow::ReorderBuffer::ForwardRange (uint16_t start, uint16_t end, MacLowRxCallback rxCallback)
+{
+  uint16_t n = (end - start + 4096) % 4096;
+  uint16_t offset = m_buffered.FindNextSet (start, n);
+  while (offset < n)
+    {
+      uint16_t seq = (start + offset) % 4096;
+      //incomplete MSDUs are dropped
+      Release (seq, m_complete.IsSet (seq) ? rxCallback : MacLowRxCallback ());
+      offset++;
+      offset += m_buffered.FindNextSet (start + offset, n - offset);
+    }
+}
+
+void
+MacLow::ReorderBuffer::Release (uint16_t seq, MacLowRxCallback rxCallback)
+{
+  uint32_t index = m_slots[seq];
+  m_slots[seq] = 0;
+  m_buffered.Reset (seq);
+  m_complete.Reset (seq);
+  while (index != 0)
+    {
+      //copy the fragment out of the pool before handing it up
+      BufferedPacket mpdu = m_entries[index - 1].mpdu;
+      m_entries[index - 1].mpdu.first = 0;
+      m_freeEntries.push_back (index - 1);
+      index = m_entries[index - 1].next;
+      if (!rxCallback.IsNull ())
         {
-          if (!(*i).second.IsMoreFragments ())
-            {
-              while (lastComplete != i)
-                {
-                  m_rxCallback ((*lastComplete).first, &(*lastComplete).second);
-                  lastComplete++;
-                }
-              m_rxCallback ((*lastComplete).first, &(*lastComplete).second);
-              lastComplete++;
-            }
-          guard = (*i).second.IsMoreFragments () ? (guard + 1) : ((guard + 16) & 0xfff0);
+          rxCallback (mpdu.first, &mpdu.second);
         }
-      (*it).second.first.SetStartingSequenceControl (guard);
-      /* All packets already forwarded to WifiMac must be removed from buffer:
-      [begin (), lastComplete) */
-      (*it).second.second.erase ((*it).second.second.begin (), lastComplete);
     }
 }
+
+std::pair<uint8_t, bool>
+MacLow::ReorderBuffer::GetContiguousFragments (uint16_t seq) const
+{
+  uint8_t count = 0;
+  for (uint32_t index = m_slots[seq]; index != 0; index = m_entries[index - 1].next)
+    {
+      const WifiMacHeader &hdr = m_entries[index - 1].mpdu.second;
+      if (hdr.GetFragmentNumber () != count)
+        {
+          break;
+        }
+      count++;
+      if (!hdr.IsMoreFragments ())
+        {
+          return std::make_pair (count, true);
+        }
+    }
+  return std::make_pair (count, false);
+}
+
 void
 MacLow::SendBlockAckResponse (const CtrlBAckResponseHeader* blockAck, Mac48Address originator, bool immediate,
                               Time duration, WifiMode blockAckReqTxMode, double rxSnr)
@@ -31,9 +31,11 @@
 #include "block-ack-cache.h"
 #include "mpdu-aggregator.h"
 #include "msdu-aggregator.h"
+#include "wifi-device-counters.h"
 
 class TwoLevelAggregationTest;
 class AmpduAggregationTest;
+class ReorderBufferTest;
 
 namespace ns3 {
 
@@ -248,6 +250,7 @@ public:
   // Allow test cases to access private members
   friend class ::TwoLevelAggregationTest;
   friend class ::AmpduAggregationTest;
+  friend class ::ReorderBufferTest;
   /**
    * typedef for a callback for MacLowRx
    */
@@ -437,6 +440,16 @@ public:
    * \param dcf listen to NAV events for every incoming and outgoing packet.
    */
   void RegisterDcf (Ptr<DcfManager> dcf);
+  /**
+   * \param counters the counters of the device, updated with the data
+   *        MPDUs sent and received by this MacLow
+   */
+  void SetCounters (Ptr<WifiDeviceCounters> counters);
+  /**
+   * \return the time the last call to StartTransmission started a frame
+   *         exchange
+   */
+  Time GetTransmissionStart (void) const;
 
   /**
    * \param packet to send (does not include the 802.11 MAC header and checksum)
@@ -494,8 +507,22 @@ public:
                                   Ptr<DcaTxop> dca);
 
   Time CalculateTfBeaconDuration (Ptr<const Packet> packet, const WifiMacHeader &hdr);
+  /**
+   * \param payloadSize the size of the TF beacon or TF body
+   * \param hdr the (broadcast) MAC header of the frame
+   *
+   * \return the duration of a TF beacon or TF, without building the packet
+   */
+  Time CalculateTfBeaconDuration (uint32_t payloadSize, const WifiMacHeader &hdr);
   uint32_t CalculateStaPayloadDuration (void);
   uint32_t CalculateApPayloadDuration (void);
+  /**
+   * \param to the STA the payload is destined to
+   * \return the duration (in microseconds) of the head-of-line AC_BE packet
+   *         queued for <i>to</i> when sent on a single RU, or zero if
+   *         nothing is queued for that STA
+   */
+  uint32_t CalculateApPayloadDuration (Mac48Address to);
   /**
    * \param packet packet received
    * \param rxSnr snr of packet received
@@ -613,6 +640,11 @@ public:
 
 
 private:
+  /**
+   * \param item the queued packet
+   * \return the duration (in microseconds) of <i>item</i> when sent on a single RU
+   */
+  uint32_t CalculateMuPayloadDuration (Ptr<const WifiMacQueueItem> item) const;
   /**
    * Cancel all scheduled events. Called before beginning a transmission
    * or switching channel.
@@ -653,6 +685,16 @@ private:
    * \return the total packet size
    */
   static uint32_t GetSize (Ptr<const Packet> packet, const WifiMacHeader *hdr, bool isAmpdu);
+  /**
+   * Return the total size of a payload of the given size after WifiMacHeader
+   * and FCS trailer have been added.
+   *
+   * \param payloadSize the size of the payload
+   * \param hdr the WifiMacHeader
+   * \param isAmpdu whether the payload is part of an A-MPDU
+   * \return the total packet size
+   */
+  static uint32_t GetSize (uint32_t payloadSize, const WifiMacHeader *hdr, bool isAmpdu);
   /**
    * Add FCS trailer to a packet.
    *
@@ -1091,6 +1133,10 @@ private:
    * \return the aggregate if MSDU aggregation succeeded, 0 otherwise
    */
   Ptr<Packet> PerformMsduAggregation (Ptr<const Packet> packet, WifiMacHeader *hdr, Time *tstamp, Ptr<Packet> currentAmpduPacket, uint16_t blockAckSize);
+  /**
+   * \return the index of the RU of this MacLow in the device counters
+   */
+  uint32_t GetCountersRu (void) const;
 
   Ptr<WifiPhy> m_phy; //!< Pointer to WifiPhy (actually send/receives frames)
   Ptr<WifiRemoteStationManager> m_stationManager; //!< Pointer to WifiRemoteStationManager (rate control)
@@ -1116,6 +1162,8 @@ private:
   typedef std::vector<Ptr<DcfManager> > DcfManagers;
   DcfManagers m_dcfManagers; //!< List of DcfManager
   Callback<void> m_tfRespAccessGrantCallback;
+  Ptr<WifiDeviceCounters> m_counters; //!< counters of the device, if any
+  Time m_txStart; //!< the time the current frame exchange started
 
   EventId m_normalAckTimeoutEvent;      //!< Normal ACK timeout event
   EventId m_fastAckTimeoutEvent;        //!< Fast ACK timeout event
@@ -1158,10 +1206,76 @@ private:
    * BlockAck data structures.
    */
   typedef std::pair<Ptr<Packet>, WifiMacHeader> BufferedPacket; //!< buffered packet typedef
-  typedef std::list<BufferedPacket>::iterator BufferedPacketI; //!< buffered packet iterator typedef
+
+  /**
+   * Receive reorder buffer of a block ack agreement. Buffered MPDUs are
+   * reached through a fixed array of slots indexed by sequence number, each
+   * slot chaining the fragments of its MSDU in fragment number order. Two
+   * bitsets track the sequence numbers that have buffered fragments and
+   * those whose MSDU is complete, so that flushes jump straight to them.
+   */
+  class ReorderBuffer
+  {
+  public:
+    ReorderBuffer ();
+
+    /**
+     * Buffer an MPDU. A copy of an already buffered fragment is dropped.
+     *
+     * \param packet the MPDU, without FCS
+     * \param hdr the MAC header of the MPDU
+     */
+    void Store (Ptr<Packet> packet, const WifiMacHeader &hdr);
+    /**
+     * Forward up, in order, the complete MSDUs starting at the given sequence
+     * number until the first incomplete or missing one.
+     *
+     * \param seq the starting sequence number
+     * \param rxCallback the callback forwarding packets up
+     * \returns the sequence control of the first missing fragment
+     */
+    uint16_t ForwardUntilFirstLost (uint16_t seq, MacLowRxCallback rxCallback);
+    /**
+     * Forward up, in order, the complete MSDUs whose sequence number lies in
+     * [<i>start</i>, <i>end</i>) and discard the incomplete ones.
+     *
+     * \param start the first sequence number
+     * \param end the sequence number following the last one
+     * \param rxCallback the callback forwarding packets up
+     */
+    void ForwardRange (uint16_t start, uint16_t end, MacLowRxCallback rxCallback);
+
+
+  private:
+    /// a buffered fragment and the pool index (plus one) of the next fragment of its MSDU
+    struct Entry
+    {
+      BufferedPacket mpdu; //!< the buffered MPDU
+      uint32_t next;       //!< pool index plus one of the next fragment, 0 if none
+    };
+
+    /**
+     * Remove the fragments of an MSDU from the buffer.
+     * \param seq the sequence number of the MSDU
+     * \param rxCallback the callback forwarding the fragments up, if not null
+     */
+    void Release (uint16_t seq, MacLowRxCallback rxCallback);
+    /**
+     * \param seq the sequence number of the MSDU
+     * \returns the number of consecutive fragments buffered from fragment 0
+     *          and whether the last of them completes the MSDU
+     */
+    std::pair<uint8_t, bool> GetContiguousFragments (uint16_t seq) const;
+
+    uint32_t m_slots[4096];               //!< per sequence number, pool index plus one of the first fragment
+    std::vector<Entry> m_entries;         //!< pool of buffered fragments
+    std::vector<uint32_t> m_freeEntries;  //!< unused pool indexes
+    SequenceBitset m_buffered;            //!< sequence numbers with buffered fragments
+    SequenceBitset m_complete;            //!< sequence numbers whose MSDU is complete
+  };
 
   typedef std::pair<Mac48Address, uint8_t> AgreementKey; //!< agreement key typedef
-  typedef std::pair<BlockAckAgreement, std::list<BufferedPacket> > AgreementValue; //!< agreement value typedef
+  typedef std::pair<BlockAckAgreement, ReorderBuffer> AgreementValue; //!< agreement value typedef
 
   typedef std::map<AgreementKey, AgreementValue> Agreements; //!< agreements
   typedef std::map<AgreementKey, AgreementValue>::iterator AgreementsI; //!< agreements iterator
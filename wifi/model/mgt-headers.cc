@@ -23,6 +23,7 @@
 #include "ns3/address-utils.h"
 #include "mgt-headers.h"
 #include "ns3/simulator.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -505,6 +506,80 @@ MgtBsrAckHeader::GetRu (void) const
   return m_ru;
 }
 
+/***********************************************************
+ *          TF User Info list (infocom)
+ ***********************************************************/
+
+namespace {
+
+/// Order User Info fields by address
+bool
+UserInfoAddrLess (const TfUserInfo &info, const Mac48Address &addr)
+{
+  return info.addr < addr;
+}
+
+} // anonymous namespace
+
+void
+TfUserInfoList::Set (const RUAllocations &alloc)
+{
+  m_userInfo.resize (alloc.size ());
+  std::vector<TfUserInfo>::iterator out = m_userInfo.begin ();
+  for (RUAllocations::const_iterator it = alloc.begin (); it != alloc.end (); ++it, ++out)
+    {
+      out->addr = it->first;
+      out->ru = it->second;
+    }
+}
+
+uint32_t
+TfUserInfoList::GetN (void) const
+{
+  return m_userInfo.size ();
+}
+
+const TfUserInfo &
+TfUserInfoList::Get (uint32_t i) const
+{
+  NS_ASSERT (i < m_userInfo.size ());
+  return m_userInfo[i];
+}
+
+bool
+TfUserInfoList::Lookup (Mac48Address addr, uint32_t *ru) const
+{
+  std::vector<TfUserInfo>::const_iterator it = std::lower_bound (m_userInfo.begin (), m_userInfo.end (),
+                                                                 addr, UserInfoAddrLess);
+  if (it == m_userInfo.end () || it->addr != addr)
+    {
+      return false;
+    }
+  *ru = it->ru;
+  return true;
+}
+
+void
+TfUserInfoList::Serialize (Buffer::Iterator &start) const
+{
+  for (std::vector<TfUserInfo>::const_iterator it = m_userInfo.begin (); it != m_userInfo.end (); ++it)
+    {
+      WriteTo (start, it->addr);
+      start.WriteHtonU32 (it->ru);
+    }
+}
+
+void
+TfUserInfoList::Deserialize (Buffer::Iterator &start, uint32_t n)
+{
+  m_userInfo.resize (n);
+  for (std::vector<TfUserInfo>::iterator it = m_userInfo.begin (); it != m_userInfo.end (); ++it)
+    {
+      ReadFrom (start, it->addr);
+      it->ru = start.ReadNtohU32 ();
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED (MgtTFBeaconHeader);
 
 
@@ -522,38 +597,18 @@ MgtTFBeaconHeader::GetTypeId (void)
 void
 MgtTFBeaconHeader::Serialize (Buffer::Iterator start) const
 {
-  start.WriteHtonU32 (m_noSta);
+  start.WriteHtonU32 (m_userInfo.GetN ());
   start.WriteHtonU32 (m_tfDuration);
-  NS_ASSERT (m_noSta == m_RUAllocations.size());
-  Mac48Address addr;
-  uint32_t ru;
-  RUAllocations::const_iterator it = m_RUAllocations.begin();
-  while (it!=m_RUAllocations.end ())
-   {
-     addr = it->first;
-     ru = it->second; 
-     WriteTo (start, addr);
-     start.WriteHtonU32 (ru);
-     it++;
-   }
+  m_userInfo.Serialize (start);
 }
 
 uint32_t 
 MgtTFBeaconHeader::Deserialize (Buffer::Iterator start)
 {
   Buffer::Iterator i = start;
-  m_noSta = i.ReadNtohU32 ();
+  uint32_t noSta = i.ReadNtohU32 ();
   m_tfDuration = i.ReadNtohU32 ();
-
-  Mac48Address addr;
-  uint32_t ru;
-  
-  for (uint32_t it = 0; it < m_noSta; it++)
-   {
-     ReadFrom (i, addr);
-     ru = i.ReadNtohU32();
-     m_RUAllocations.insert(std::pair<Mac48Address, uint32_t> (addr, ru));
-   }
+  m_userInfo.Deserialize (i, noSta);
 
   uint32_t dist = i.GetDistanceFrom(start);
   return dist;
@@ -562,38 +617,37 @@ MgtTFBeaconHeader::Deserialize (Buffer::Iterator start)
 uint32_t 
 MgtTFBeaconHeader::GetSerializedSize (void) const
 {
-  uint32_t size = 4 + 4 + m_noSta * (6 + 4);
-  return size;
+  return GetSizeForNoSta (m_userInfo.GetN ());
 }
 
-void 
-MgtTFBeaconHeader::SetRUAllocations (RUAllocations alloc)
+uint32_t
+MgtTFBeaconHeader::GetSizeForNoSta (uint32_t noSta)
 {
-  m_RUAllocations = alloc;
+  return 4 + 4 + noSta * TfUserInfoList::USER_INFO_SIZE;
 }
 
-MgtTFBeaconHeader::RUAllocations 
-MgtTFBeaconHeader::GetRUAllocations (void) const
+void 
+MgtTFBeaconHeader::SetRUAllocations (const RUAllocations &alloc)
 {
-  return m_RUAllocations;
+  m_userInfo.Set (alloc);
 }
 
-void 
-MgtTFBeaconHeader::SetNoSta (uint32_t n)
+const TfUserInfoList &
+MgtTFBeaconHeader::GetUserInfo (void) const
 {
-  m_noSta = n;
+  return m_userInfo;
 }
 
 uint32_t 
 MgtTFBeaconHeader::GetNoSta (void) const
 {
-  return m_noSta;
+  return m_userInfo.GetN ();
 }
 
 void 
 MgtTFBeaconHeader::Print (std::ostream &os) const
 {
-  os << "noSta = " << m_noSta;
+  os << "noSta = " << m_userInfo.GetN ();
 }
 
 TypeId
@@ -702,41 +756,20 @@ MgtTFHeader::GetTypeId (void)
 void
 MgtTFHeader::Serialize (Buffer::Iterator start) const
 {
-  start.WriteHtonU32 (m_noSta);
+  start.WriteHtonU32 (m_userInfo.GetN ());
   start.WriteHtonU32 (m_ulFlag);
   start.WriteHtonU32 (m_tfDuration);
-
-  NS_ASSERT (m_noSta == m_RUAllocations.size());
-  Mac48Address addr;
-  uint32_t ru;
-  RUAllocations::const_iterator it = m_RUAllocations.begin();
-  while (it!=m_RUAllocations.end ())
-   {
-     addr = it->first;
-     ru = it->second; 
-     WriteTo (start, addr);
-     start.WriteHtonU32 (ru);
-     it++;
-   }
+  m_userInfo.Serialize (start);
 }
 
 uint32_t 
 MgtTFHeader::Deserialize (Buffer::Iterator start)
 {
   Buffer::Iterator i = start;
-  m_noSta = i.ReadNtohU32 ();
+  uint32_t noSta = i.ReadNtohU32 ();
   m_ulFlag = i.ReadNtohU32 ();
   m_tfDuration = i.ReadNtohU32 ();
-
-  Mac48Address addr;
-  uint32_t ru;
-  
-  for (uint32_t it = 0; it < m_noSta; it++)
-   {
-     ReadFrom (i, addr);
-     ru = i.ReadNtohU32();
-     m_RUAllocations.insert(std::pair<Mac48Address, uint32_t> (addr, ru));
-   }
+  m_userInfo.Deserialize (i, noSta);
 
   uint32_t dist = i.GetDistanceFrom(start);
   return dist;
@@ -745,8 +778,13 @@ MgtTFHeader::Deserialize (Buffer::Iterator start)
 uint32_t 
 MgtTFHeader::GetSerializedSize (void) const
 {
-  uint32_t size = 4 + 4 + m_noSta * (6 + 4) + 4;
-  return size;
+  return GetSizeForNoSta (m_userInfo.GetN ());
+}
+
+uint32_t
+MgtTFHeader::GetSizeForNoSta (uint32_t noSta)
+{
+  return 4 + 4 + noSta * TfUserInfoList::USER_INFO_SIZE + 4;
 }
 
 uint32_t
@@ -773,33 +811,27 @@ MgtTFHeader::GetUplinkFlag (void) const
   return m_ulFlag;
 }
 void 
-MgtTFHeader::SetRUAllocations (RUAllocations alloc)
+MgtTFHeader::SetRUAllocations (const RUAllocations &alloc)
 {
-  m_RUAllocations = alloc;
+  m_userInfo.Set (alloc);
 }
 
-MgtTFHeader::RUAllocations 
-MgtTFHeader::GetRUAllocations (void) const
-{
-  return m_RUAllocations;
-}
-
-void 
-MgtTFHeader::SetNoSta (uint32_t n)
+const TfUserInfoList &
+MgtTFHeader::GetUserInfo (void) const
 {
-  m_noSta = n;
+  return m_userInfo;
 }
 
 uint32_t 
 MgtTFHeader::GetNoSta (void) const
 {
-  return m_noSta;
+  return m_userInfo.GetN ();
 }
 
 void 
 MgtTFHeader::Print (std::ostream &os) const
 {
-  os << "Number of stations allocated " << m_noSta << ", "
+  os << "Number of stations allocated " << m_userInfo.GetN () << ", "
      << "ULFlag " << m_ulFlag;
 }
 
@@ -36,6 +36,7 @@
 #include "edca-parameter-set.h"
 #include "he-capabilities.h"
 #include <map> //infocom
+#include <vector> //infocom
 #include "ns3/mac48-address.h" //infocom
  
 namespace ns3 {
@@ -636,6 +637,74 @@ private:
   uint16_t m_ru;
 };
 
+/**
+ * \ingroup wifi
+ * infocom: one User Info field of a TF beacon or TF, i.e. a STA and the RU
+ * it is allocated (the broadcast address denotes a random access RU).
+ * On air it takes a fixed 10 byte record: the address, then the RU index
+ * in network order.
+ */
+struct TfUserInfo
+{
+  Mac48Address addr; //!< the STA the RU is allocated to
+  uint32_t ru;       //!< the RU index
+};
+
+/**
+ * \ingroup wifi
+ * infocom: contiguous list of User Info fields, sorted by address so that
+ * a STA finds its own entry with a binary search.
+ */
+class TfUserInfoList
+{
+public:
+  /// Size in bytes of one serialized User Info field
+  static const uint32_t USER_INFO_SIZE = 6 + 4;
+
+  typedef std::map<Mac48Address, uint32_t> RUAllocations; //!< allocations as kept by the AP
+
+  /**
+   * Replace the list with the given allocations. The map is already sorted
+   * by address, so this is a linear copy.
+   *
+   * \param alloc the RU allocations
+   */
+  void Set (const RUAllocations &alloc);
+  /**
+   * \return the number of User Info fields
+   */
+  uint32_t GetN (void) const;
+  /**
+   * \param i the index of a User Info field
+   * \return the i-th User Info field, in address order
+   */
+  const TfUserInfo & Get (uint32_t i) const;
+  /**
+   * Look up the RU allocated to the given address.
+   *
+   * \param addr the address to look for
+   * \param ru the RU allocated to addr, if any
+   * \return true if addr has an RU
+   */
+  bool Lookup (Mac48Address addr, uint32_t *ru) const;
+  /**
+   * Write the User Info fields as consecutive fixed size records.
+   *
+   * \param start the buffer iterator
+   */
+  void Serialize (Buffer::Iterator &start) const;
+  /**
+   * Read n fixed size User Info records.
+   *
+   * \param start the buffer iterator
+   * \param n the number of records to read
+   */
+  void Deserialize (Buffer::Iterator &start, uint32_t n);
+
+private:
+  std::vector<TfUserInfo> m_userInfo; //!< User Info fields sorted by address
+};
+
 class MgtTFBeaconHeader : public Header
 {
 public:
@@ -645,14 +714,21 @@ public:
    * \return The TypeId.
    */
 
-  typedef std::map<Mac48Address, uint32_t> RUAllocations;
+  typedef TfUserInfoList::RUAllocations RUAllocations;
   static TypeId GetTypeId (void);
   void Serialize (Buffer::Iterator start) const;
   uint32_t Deserialize (Buffer::Iterator start);
   uint32_t GetSerializedSize (void) const; 
-  void SetRUAllocations (RUAllocations alloc);
-  RUAllocations GetRUAllocations (void) const;
-  void SetNoSta (uint32_t n);
+  /**
+   * \param noSta the number of User Info fields
+   * \return the serialized size of a TF beacon carrying noSta User Info fields
+   */
+  static uint32_t GetSizeForNoSta (uint32_t noSta);
+  void SetRUAllocations (const RUAllocations &alloc);
+  /**
+   * \return the User Info fields, sorted by address
+   */
+  const TfUserInfoList & GetUserInfo (void) const;
   uint32_t GetNoSta (void) const; 
   TypeId GetInstanceTypeId (void) const;
   void Print (std::ostream &os) const; 
@@ -660,8 +736,7 @@ public:
   uint32_t GetTfDuration (void) const;
 
 private: 
-  RUAllocations m_RUAllocations; 
-  uint32_t m_noSta;
+  TfUserInfoList m_userInfo; //!< infocom: the RU allocations
   uint32_t m_tfDuration;
 };
 
@@ -689,15 +764,22 @@ private:
 class MgtTFHeader : public Header
 {
 public:
-  typedef std::map<Mac48Address, uint32_t> RUAllocations;
+  typedef TfUserInfoList::RUAllocations RUAllocations;
   static TypeId GetTypeId (void);
   TypeId GetInstanceTypeId (void) const;
   void Serialize (Buffer::Iterator start) const;
   uint32_t Deserialize (Buffer::Iterator start);
   uint32_t GetSerializedSize (void) const;
-  RUAllocations GetRUAllocations (void) const;
-  void SetRUAllocations (RUAllocations alloc);
-  void SetNoSta (uint32_t n);
+  /**
+   * \param noSta the number of User Info fields
+   * \return the serialized size of a TF carrying noSta User Info fields
+   */
+  static uint32_t GetSizeForNoSta (uint32_t noSta);
+  /**
+   * \return the User Info fields, sorted by address
+   */
+  const TfUserInfoList & GetUserInfo (void) const;
+  void SetRUAllocations (const RUAllocations &alloc);
   uint32_t GetNoSta (void) const;
   void SetUplinkFlag (uint32_t flag);
   uint32_t GetUplinkFlag (void) const; 
@@ -706,8 +788,7 @@ public:
   void Print (std::ostream &os) const;
 
 private:
-  RUAllocations m_RUAllocations;
-  uint32_t m_noSta;
+  TfUserInfoList m_userInfo; //!< infocom: the RU allocations
   uint32_t m_ulFlag;
   uint32_t m_tfDuration;
 };
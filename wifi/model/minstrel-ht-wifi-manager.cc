@@ -42,12 +42,67 @@
 #include "wifi-mac.h"
 #include "wifi-phy.h"
 #include <iomanip>
+#include <algorithm>
+#include <map>
 
 #define Min(a,b) ((a < b) ? a : b)
 #define Max(a,b) ((a > b) ? a : b)
 
 NS_LOG_COMPONENT_DEFINE ("MinstrelHtWifiManager");
 
+namespace {
+
+/**
+ * Key of the shared TX times tables: frame length, frequency and STBC.
+ * The MPDU durations used by Minstrel-HT depend on nothing else.
+ */
+struct TxTimesKey
+{
+  TxTimesKey (uint32_t frameLength, uint16_t frequency, bool stbc)
+    : frameLength (frameLength),
+      frequency (frequency),
+      stbc (stbc)
+  {
+  }
+  /**
+   * \param o the other key
+   * \return true if this key is ordered before o
+   */
+  bool operator< (const TxTimesKey &o) const
+  {
+    if (frameLength != o.frameLength)
+      {
+        return frameLength < o.frameLength;
+      }
+    if (frequency != o.frequency)
+      {
+        return frequency < o.frequency;
+      }
+    return stbc < o.stbc;
+  }
+  uint32_t frameLength; ///< frame length
+  uint16_t frequency;   ///< frequency
+  bool stbc;            ///< STBC
+};
+
+/// TX times of all the groups, indexed by groupId, for each key
+typedef std::map<TxTimesKey, std::vector<ns3::McsGroupTxTimes> > TxTimesCache;
+
+/**
+ * The tables are shared by all the managers of the process. Managers keep
+ * pointers to them, so the cache is never destroyed.
+ *
+ * \return the TX times cache
+ */
+TxTimesCache &
+GetTxTimesCache (void)
+{
+  static TxTimesCache *cache = new TxTimesCache ();
+  return *cache;
+}
+
+} //anonymous namespace
+
 namespace ns3 {
 
 ///MinstrelHtWifiRemoteStation structure
@@ -71,6 +126,8 @@ struct MinstrelHtWifiRemoteStation : MinstrelWifiRemoteStation
   bool m_isHt;                 //!< If the station is HT capable.
 
   std::ofstream m_statsFile;   //!< File where statistics table is written.
+
+  double m_lastSnr;            //!< Last SNR reported for the station, 0 if none (fast mode).
 };
 
 void
@@ -132,6 +189,18 @@ MinstrelHtWifiManager::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&MinstrelHtWifiManager::m_printStats),
                    MakeBooleanChecker ())
+    .AddAttribute ("FastModeRates",
+                   "If not zero, once an SNR is known for a station, update the statistics of only "
+                   "this number of rates, the fastest ones whose SNR threshold is below that SNR, "
+                   "and do not sample other rates",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MinstrelHtWifiManager::m_fastModeRates),
+                   MakeUintegerChecker <uint32_t> ())
+    .AddAttribute ("FastModeBerThreshold",
+                   "The Bit Error Rate used to compute the SNR thresholds of the rates in fast mode",
+                   DoubleValue (1e-5),
+                   MakeDoubleAccessor (&MinstrelHtWifiManager::m_fastModeBer),
+                   MakeDoubleChecker<double> ())
     .AddTraceSource ("RateChange",
                      "The transmission rate has changed",
                      MakeTraceSourceAccessor (&MinstrelHtWifiManager::m_rateChange),
@@ -156,14 +225,6 @@ MinstrelHtWifiManager::MinstrelHtWifiManager ()
 MinstrelHtWifiManager::~MinstrelHtWifiManager ()
 {
   NS_LOG_FUNCTION (this);
-  if (HasHtSupported ())
-    {
-      for (uint32_t i = 0; i < m_numGroups; i++)
-        {
-          m_minstrelGroups[i].ratesFirstMpduTxTimeTable.clear ();
-          m_minstrelGroups[i].ratesTxTimeTable.clear ();
-        }
-    }
 }
 
 int64_t
@@ -236,6 +297,7 @@ MinstrelHtWifiManager::DoInitialize ()
                   m_minstrelGroups[groupId].chWidth = chWidth;
                   m_minstrelGroups[groupId].isVht = false;
                   m_minstrelGroups[groupId].isSupported = false;
+                  m_minstrelGroups[groupId].txTimes = 0;
 
                   // Check capabilities of the device
                   if (!(!GetPhy ()->GetShortGuardInterval () && m_minstrelGroups[groupId].sgi)                   ///Is SGI supported by the transmitter?
@@ -243,16 +305,7 @@ MinstrelHtWifiManager::DoInitialize ()
                       && (GetPhy ()->GetMaxSupportedTxSpatialStreams () >= m_minstrelGroups[groupId].streams))  ///Are streams supported by the transmitter?
                     {
                       m_minstrelGroups[groupId].isSupported = true;
-
-                      // Calculate tx time for all rates of the group
-                      WifiModeList htMcsList = GetHtDeviceMcsList ();
-                      for (uint8_t i = 0; i < MAX_HT_GROUP_RATES; i++)
-                        {
-                          uint32_t deviceIndex = i + (m_minstrelGroups[groupId].streams - 1) * 8;
-                          WifiMode mode =  htMcsList[deviceIndex];
-                          AddFirstMpduTxTime (groupId, mode, CalculateFirstMpduTxDuration (GetPhy (), streams, sgi, chWidth, mode));
-                          AddMpduTxTime (groupId, mode, CalculateMpduTxDuration (GetPhy (), streams, sgi, chWidth, mode));
-                        }
+                      m_minstrelGroups[groupId].txTimes = GetSharedTxTimes (groupId);
                       NS_LOG_DEBUG ("Initialized group " << groupId << ": (" << (uint16_t)streams << "," << (uint16_t)sgi << "," << (uint16_t)chWidth << ")");
                     }
                 }
@@ -275,6 +328,7 @@ MinstrelHtWifiManager::DoInitialize ()
                       m_minstrelGroups[groupId].chWidth = chWidth;
                       m_minstrelGroups[groupId].isVht = true;
                       m_minstrelGroups[groupId].isSupported = false;
+                      m_minstrelGroups[groupId].txTimes = 0;
 
                       // Check capabilities of the device
                       if (!(!GetPhy ()->GetShortGuardInterval () && m_minstrelGroups[groupId].sgi)                   ///Is SGI supported by the transmitter?
@@ -282,25 +336,55 @@ MinstrelHtWifiManager::DoInitialize ()
                           && (GetPhy ()->GetMaxSupportedTxSpatialStreams () >= m_minstrelGroups[groupId].streams))  ///Are streams supported by the transmitter?
                         {
                           m_minstrelGroups[groupId].isSupported = true;
-
-                          // Calculate tx time for all rates of the group
-                          WifiModeList vhtMcsList = GetVhtDeviceMcsList ();
-                          for (uint8_t i = 0; i < MAX_VHT_GROUP_RATES; i++)
-                            {
-                              WifiMode mode = vhtMcsList[i];
-                              // Check for invalid VHT MCSs and do not add time to array.
-                              if (IsValidMcs (GetPhy (), streams, chWidth, mode))
-                                {
-                                  AddFirstMpduTxTime (groupId, mode, CalculateFirstMpduTxDuration (GetPhy (), streams, sgi, chWidth, mode));
-                                  AddMpduTxTime (groupId, mode, CalculateMpduTxDuration (GetPhy (), streams, sgi, chWidth, mode));
-                                }
-                            }
+                          m_minstrelGroups[groupId].txTimes = GetSharedTxTimes (groupId);
                           NS_LOG_DEBUG ("Initialized group " << groupId << ": (" << (uint16_t)streams << "," << (uint16_t)sgi << "," << (uint16_t)chWidth << ")");
                         }
                     }
                 }
             }
         }
+
+      if (m_fastModeRates > 0)
+        {
+          InitFastMode ();
+        }
+    }
+}
+
+void
+MinstrelHtWifiManager::InitFastMode (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<std::pair<Time, uint32_t> > rates;
+  m_fastModeThresholds = std::vector<double> (m_numGroups * m_numRates, 0);
+  for (uint32_t groupId = 0; groupId < m_numGroups; groupId++)
+    {
+      const McsGroup &group = m_minstrelGroups[groupId];
+      if (!group.isSupported)
+        {
+          continue;
+        }
+      for (uint32_t rateId = 0; rateId < group.txTimes->modes.size (); rateId++)
+        {
+          Time txTime = group.txTimes->firstMpduTxTimes[rateId];
+          if (!txTime.IsStrictlyPositive ())
+            {
+              continue; //Invalid VHT MCS
+            }
+          WifiTxVector txVector;
+          txVector.SetNss (group.streams);
+          txVector.SetGuardInterval (group.sgi ? 400 : 800);
+          txVector.SetChannelWidth (group.chWidth);
+          txVector.SetMode (group.txTimes->modes[rateId]);
+          m_fastModeThresholds[GetIndex (groupId, rateId)] = GetPhy ()->CalculateSnr (txVector, m_fastModeBer);
+          rates.push_back (std::make_pair (txTime, GetIndex (groupId, rateId)));
+        }
+    }
+  std::sort (rates.begin (), rates.end ());
+  m_fastModeOrder.clear ();
+  for (std::vector<std::pair<Time, uint32_t> >::const_iterator i = rates.begin (); i != rates.end (); i++)
+    {
+      m_fastModeOrder.push_back (i->second);
     }
 }
 
@@ -356,52 +440,76 @@ MinstrelHtWifiManager::CalculateMpduTxDuration (Ptr<WifiPhy> phy, uint8_t stream
   return phy->CalculateTxDuration (m_frameLength, txvector, phy->GetFrequency (), MPDU_IN_AGGREGATE, 0);
 }
 
-Time
-MinstrelHtWifiManager::GetFirstMpduTxTime (uint32_t groupId, WifiMode mode) const
+const McsGroupTxTimes *
+MinstrelHtWifiManager::GetSharedTxTimes (uint32_t groupId)
 {
-  NS_LOG_FUNCTION (this << groupId << mode);
+  NS_LOG_FUNCTION (this << groupId);
+  Ptr<WifiPhy> phy = GetPhy ();
+  const McsGroup &group = m_minstrelGroups[groupId];
 
-  for (TxTime::const_iterator i = m_minstrelGroups[groupId].ratesFirstMpduTxTimeTable.begin (); i != m_minstrelGroups[groupId].ratesFirstMpduTxTimeTable.end (); i++)
+  std::vector<McsGroupTxTimes> &groups = GetTxTimesCache ()[TxTimesKey (m_frameLength, phy->GetFrequency (), phy->GetStbc ())];
+  if (groups.empty ())
     {
-      if (mode == i->second)
+      // Sized once for both HT and VHT groups, so that the tables never move
+      groups.resize (MAX_SUPPORTED_STREAMS * (MAX_HT_STREAM_GROUPS + MAX_VHT_STREAM_GROUPS));
+    }
+  McsGroupTxTimes &txTimes = groups[groupId];
+  if (!txTimes.modes.empty ())
+    {
+      return &txTimes;
+    }
+
+  // Calculate tx time for all rates of the group
+  NS_LOG_DEBUG ("Calculate TX times of group " << groupId << " for frame length " << m_frameLength);
+  WifiModeList mcsList = group.isVht ? GetVhtDeviceMcsList () : GetHtDeviceMcsList ();
+  uint8_t nRates = group.isVht ? MAX_VHT_GROUP_RATES : MAX_HT_GROUP_RATES;
+  for (uint8_t i = 0; i < nRates; i++)
+    {
+      uint32_t deviceIndex = group.isVht ? i : i + (group.streams - 1) * MAX_HT_GROUP_RATES;
+      WifiMode mode = mcsList[deviceIndex];
+      txTimes.modes.push_back (mode);
+      // Check for invalid VHT MCSs and do not add time to array.
+      if (!group.isVht || IsValidMcs (phy, group.streams, group.chWidth, mode))
         {
-          return i->first;
+          txTimes.firstMpduTxTimes.push_back (CalculateFirstMpduTxDuration (phy, group.streams, group.sgi, group.chWidth, mode));
+          txTimes.txTimes.push_back (CalculateMpduTxDuration (phy, group.streams, group.sgi, group.chWidth, mode));
+        }
+      else
+        {
+          txTimes.firstMpduTxTimes.push_back (Seconds (0));
+          txTimes.txTimes.push_back (Seconds (0));
         }
     }
-  NS_ASSERT (false);
-  return Seconds (0);
+  return &txTimes;
 }
 
-void
-MinstrelHtWifiManager::AddFirstMpduTxTime (uint32_t groupId, WifiMode mode, Time t)
+uint8_t
+MinstrelHtWifiManager::GetTxTimeIndex (uint32_t groupId, WifiMode mode) const
 {
-  NS_LOG_FUNCTION (this << groupId << mode << t);
-
-  m_minstrelGroups[groupId].ratesFirstMpduTxTimeTable.push_back (std::make_pair (t, mode));
+  const McsGroupTxTimes *txTimes = m_minstrelGroups[groupId].txTimes;
+  NS_ASSERT (txTimes != 0);
+  // HT MCSs are numbered across the groups of all the stream numbers
+  uint8_t index = m_minstrelGroups[groupId].isVht ? mode.GetMcsValue () : mode.GetMcsValue () % MAX_HT_GROUP_RATES;
+  NS_ASSERT (index < txTimes->modes.size () && txTimes->modes[index] == mode);
+  return index;
 }
 
 Time
-MinstrelHtWifiManager::GetMpduTxTime (uint32_t groupId, WifiMode mode) const
+MinstrelHtWifiManager::GetFirstMpduTxTime (uint32_t groupId, WifiMode mode) const
 {
   NS_LOG_FUNCTION (this << groupId << mode);
-
-  for (TxTime::const_iterator i = m_minstrelGroups[groupId].ratesTxTimeTable.begin (); i != m_minstrelGroups[groupId].ratesTxTimeTable.end (); i++)
-    {
-      if (mode == i->second)
-        {
-          return i->first;
-        }
-    }
-  NS_ASSERT (false);
-  return Seconds (0);
+  Time txTime = m_minstrelGroups[groupId].txTimes->firstMpduTxTimes[GetTxTimeIndex (groupId, mode)];
+  NS_ASSERT (txTime.IsStrictlyPositive ());
+  return txTime;
 }
 
-void
-MinstrelHtWifiManager::AddMpduTxTime (uint32_t groupId, WifiMode mode, Time t)
+Time
+MinstrelHtWifiManager::GetMpduTxTime (uint32_t groupId, WifiMode mode) const
 {
-  NS_LOG_FUNCTION (this << groupId << mode << t);
-
-  m_minstrelGroups[groupId].ratesTxTimeTable.push_back (std::make_pair (t, mode));
+  NS_LOG_FUNCTION (this << groupId << mode);
+  Time txTime = m_minstrelGroups[groupId].txTimes->txTimes[GetTxTimeIndex (groupId, mode)];
+  NS_ASSERT (txTime.IsStrictlyPositive ());
+  return txTime;
 }
 
 WifiRemoteStation *
@@ -440,6 +548,8 @@ MinstrelHtWifiManager::DoCreateStation (void) const
   station->m_ampduLen = 0;
   station->m_ampduPacketCount = 0;
 
+  station->m_lastSnr = 0;
+
   // If the device supports HT
   if (HasHtSupported () || HasVhtSupported ())
     {
@@ -495,9 +605,12 @@ MinstrelHtWifiManager::CheckInit (MinstrelHtWifiRemoteStation *station)
           station->m_sampleTable = SampleRate (m_numRates, std::vector<uint32_t> (m_nSampleCol));
           InitSampleTable (station);
           RateInit (station);
-          std::ostringstream tmp;
-          tmp << "minstrel-ht-stats-" << station->m_state->m_address << ".txt";
-          station->m_statsFile.open (tmp.str ().c_str (), std::ios::out);
+          if (m_printStats)
+            {
+              std::ostringstream tmp;
+              tmp << "minstrel-ht-stats-" << station->m_state->m_address << ".txt";
+              station->m_statsFile.open (tmp.str ().c_str (), std::ios::out);
+            }
           station->m_initialized = true;
         }
     }
@@ -510,6 +623,7 @@ MinstrelHtWifiManager::DoReportRxOk (WifiRemoteStation *st,
   NS_LOG_FUNCTION (this << st);
 
   NS_LOG_DEBUG ("DoReportRxOk m_txrate=" << ((MinstrelHtWifiRemoteStation *)st)->m_txrate);
+  UpdateSnr ((MinstrelHtWifiRemoteStation *)st, rxSnr);
 }
 
 void
@@ -597,6 +711,7 @@ MinstrelHtWifiManager::DoReportDataOk (WifiRemoteStation *st,
     }
 
   NS_LOG_DEBUG ("Data OK - Txrate = " << station->m_txrate  );
+  UpdateSnr (station, dataSnr);
 
   if (!station->m_isHt)
     {
@@ -709,6 +824,7 @@ MinstrelHtWifiManager::DoReportAmpduTxStatus (WifiRemoteStation *st, uint8_t nSu
 
   station->m_ampduPacketCount++;
   station->m_ampduLen += nSuccessfulMpdus + nFailedMpdus;
+  UpdateSnr (station, dataSnr);
 
   UpdatePacketCounters (station, nSuccessfulMpdus, nFailedMpdus);
 
@@ -842,6 +958,16 @@ MinstrelHtWifiManager::UpdateRate (MinstrelHtWifiRemoteStation *station)
   NS_LOG_DEBUG ("Next rate to use TxRate = " << station->m_txrate);
 }
 
+void
+MinstrelHtWifiManager::UpdateSnr (MinstrelHtWifiRemoteStation *station, double snr)
+{
+  NS_LOG_FUNCTION (this << station << snr);
+  if (m_fastModeRates > 0 && snr > 0)
+    {
+      station->m_lastSnr = snr;
+    }
+}
+
 void
 MinstrelHtWifiManager::UpdateRetry (MinstrelHtWifiRemoteStation *station)
 {
@@ -1140,6 +1266,12 @@ MinstrelHtWifiManager::FindRate (MinstrelHtWifiRemoteStation *station)
       return station->m_maxTpRate;
     }
 
+  // In fast mode, the SNR replaces sampling to find the candidate rates.
+  if (m_fastModeRates > 0 && station->m_lastSnr > 0)
+    {
+      return station->m_maxTpRate;
+    }
+
   // If we have waited enough, then sample.
   if (station->m_sampleWait == 0 && station->m_sampleTries != 0)
     {
@@ -1246,8 +1378,6 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
   station->m_numSamplesSlow = 0;
   station->m_sampleCount = 0;
 
-  double tempProb;
-
   if (station->m_ampduPacketCount > 0)
     {
       double newLen = station->m_ampduLen / station->m_ampduPacketCount;
@@ -1262,6 +1392,7 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
   station->m_maxProbRate = GetLowestIndex (station);
 
   /// Update throughput and EWMA for each rate inside each group.
+  bool fastMode = m_fastModeRates > 0 && station->m_lastSnr > 0;
   for (uint32_t j = 0; j < m_numGroups; j++)
     {
       if (station->m_groupsTable[j].m_supported)
@@ -1273,69 +1404,23 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
           station->m_groupsTable[j].m_maxTpRate2 = GetLowestIndex (station, j);
           station->m_groupsTable[j].m_maxProbRate = GetLowestIndex (station, j);
 
+          if (fastMode)
+            {
+              continue;
+            }
           for (uint32_t i = 0; i < m_numRates; i++)
             {
               if (station->m_groupsTable[j].m_ratesTable[i].supported)
                 {
-                  station->m_groupsTable[j].m_ratesTable[i].retryUpdated = false;
-
-                  NS_LOG_DEBUG (i << " " << GetMcsSupported (station,  station->m_groupsTable[j].m_ratesTable[i].mcsIndex) <<
-                                "\t attempt=" << station->m_groupsTable[j].m_ratesTable[i].numRateAttempt <<
-                                "\t success=" << station->m_groupsTable[j].m_ratesTable[i].numRateSuccess);
-
-                  /// If we've attempted something.
-                  if (station->m_groupsTable[j].m_ratesTable[i].numRateAttempt > 0)
-                    {
-                      station->m_groupsTable[j].m_ratesTable[i].numSamplesSkipped = 0;
-                      /**
-                       * Calculate the probability of success.
-                       * Assume probability scales from 0 to 100.
-                       */
-                      tempProb = (100 * station->m_groupsTable[j].m_ratesTable[i].numRateSuccess) / station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
-
-                      /// Bookeeping.
-                      station->m_groupsTable[j].m_ratesTable[i].prob = tempProb;
-
-                      if (station->m_groupsTable[j].m_ratesTable[i].successHist == 0)
-                        {
-                          station->m_groupsTable[j].m_ratesTable[i].ewmaProb = tempProb;
-                        }
-                      else
-                        {
-                          station->m_groupsTable[j].m_ratesTable[i].ewmsdProb = CalculateEwmsd (station->m_groupsTable[j].m_ratesTable[i].ewmsdProb,
-                                                                                                tempProb, station->m_groupsTable[j].m_ratesTable[i].ewmaProb,
-                                                                                                m_ewmaLevel);
-                          /// EWMA probability
-                          tempProb = (tempProb * (100 - m_ewmaLevel) + station->m_groupsTable[j].m_ratesTable[i].ewmaProb * m_ewmaLevel)  / 100;
-                          station->m_groupsTable[j].m_ratesTable[i].ewmaProb = tempProb;
-                        }
-
-                      station->m_groupsTable[j].m_ratesTable[i].throughput = CalculateThroughput (station, j, i, tempProb);
-
-                      station->m_groupsTable[j].m_ratesTable[i].successHist += station->m_groupsTable[j].m_ratesTable[i].numRateSuccess;
-                      station->m_groupsTable[j].m_ratesTable[i].attemptHist += station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
-                    }
-                  else
-                    {
-                      station->m_groupsTable[j].m_ratesTable[i].numSamplesSkipped++;
-                    }
-
-                  /// Bookeeping.
-                  station->m_groupsTable[j].m_ratesTable[i].prevNumRateSuccess = station->m_groupsTable[j].m_ratesTable[i].numRateSuccess;
-                  station->m_groupsTable[j].m_ratesTable[i].prevNumRateAttempt = station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
-                  station->m_groupsTable[j].m_ratesTable[i].numRateSuccess = 0;
-                  station->m_groupsTable[j].m_ratesTable[i].numRateAttempt = 0;
-
-                  if (station->m_groupsTable[j].m_ratesTable[i].throughput != 0)
-                    {
-                      SetBestStationThRates (station, GetIndex (j, i));
-                      SetBestProbabilityRate (station, GetIndex (j, i));
-                    }
-
+                  UpdateRateStats (station, j, i);
                 }
             }
         }
     }
+  if (fastMode)
+    {
+      UpdateFastModeStats (station);
+    }
 
   //Try to sample all available rates during each interval.
   station->m_sampleCount *= 8;
@@ -1352,6 +1437,103 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
     }
 }
 
+void
+MinstrelHtWifiManager::UpdateRateStats (MinstrelHtWifiRemoteStation *station, uint32_t groupId, uint32_t rateId)
+{
+  NS_LOG_FUNCTION (this << station << groupId << rateId);
+  HtRateInfo &rate = station->m_groupsTable[groupId].m_ratesTable[rateId];
+  double tempProb;
+
+  rate.retryUpdated = false;
+
+  NS_LOG_DEBUG (rateId << " " << GetMcsSupported (station,  rate.mcsIndex) <<
+                "\t attempt=" << rate.numRateAttempt <<
+                "\t success=" << rate.numRateSuccess);
+
+  /// If we've attempted something.
+  if (rate.numRateAttempt > 0)
+    {
+      rate.numSamplesSkipped = 0;
+      /**
+       * Calculate the probability of success.
+       * Assume probability scales from 0 to 100.
+       */
+      tempProb = (100 * rate.numRateSuccess) / rate.numRateAttempt;
+
+      /// Bookeeping.
+      rate.prob = tempProb;
+
+      if (rate.successHist == 0)
+        {
+          rate.ewmaProb = tempProb;
+        }
+      else
+        {
+          rate.ewmsdProb = CalculateEwmsd (rate.ewmsdProb, tempProb, rate.ewmaProb, m_ewmaLevel);
+          /// EWMA probability
+          tempProb = (tempProb * (100 - m_ewmaLevel) + rate.ewmaProb * m_ewmaLevel)  / 100;
+          rate.ewmaProb = tempProb;
+        }
+
+      rate.throughput = CalculateThroughput (station, groupId, rateId, tempProb);
+
+      rate.successHist += rate.numRateSuccess;
+      rate.attemptHist += rate.numRateAttempt;
+    }
+  else
+    {
+      rate.numSamplesSkipped++;
+    }
+
+  /// Bookeeping.
+  rate.prevNumRateSuccess = rate.numRateSuccess;
+  rate.prevNumRateAttempt = rate.numRateAttempt;
+  rate.numRateSuccess = 0;
+  rate.numRateAttempt = 0;
+
+  if (rate.throughput != 0)
+    {
+      SetBestStationThRates (station, GetIndex (groupId, rateId));
+      SetBestProbabilityRate (station, GetIndex (groupId, rateId));
+    }
+}
+
+void
+MinstrelHtWifiManager::UpdateFastModeStats (MinstrelHtWifiRemoteStation *station)
+{
+  NS_LOG_FUNCTION (this << station << station->m_lastSnr);
+  uint32_t nCandidates = 0;
+  for (std::vector<uint32_t>::const_iterator it = m_fastModeOrder.begin ();
+       it != m_fastModeOrder.end () && nCandidates < m_fastModeRates; it++)
+    {
+      uint32_t groupId = GetGroupId (*it);
+      uint32_t rateId = GetRateId (*it);
+      // Skip the groups and rates the station does not support, and the
+      // rates that cannot work at the last SNR.
+      if (!station->m_groupsTable[groupId].m_supported
+          || !station->m_groupsTable[groupId].m_ratesTable[rateId].supported
+          || m_fastModeThresholds[*it] > station->m_lastSnr)
+        {
+          continue;
+        }
+      nCandidates++;
+      HtRateInfo &rate = station->m_groupsTable[groupId].m_ratesTable[rateId];
+      if (rate.attemptHist == 0 && rate.numRateAttempt == 0)
+        {
+          // Never tried: rely on the SNR instead of sampling it.
+          rate.ewmaProb = 100;
+          rate.throughput = CalculateThroughput (station, groupId, rateId, rate.ewmaProb);
+          SetBestStationThRates (station, *it);
+          SetBestProbabilityRate (station, *it);
+        }
+      else
+        {
+          UpdateRateStats (station, groupId, rateId);
+        }
+    }
+  NS_LOG_DEBUG ("Fast mode: " << nCandidates << " candidate rates at snr " << station->m_lastSnr);
+}
+
 double
 MinstrelHtWifiManager::CalculateThroughput (MinstrelHtWifiRemoteStation *station, uint32_t groupId, uint32_t rateId, double ewmaProb)
 {
@@ -32,14 +32,27 @@
 namespace ns3 {
 
 /**
- * Data structure to save transmission time calculations per rate.
- * A vector of Time, WifiMode pairs.
+ * Data structure to save transmission time calculations per rate of a group.
+ * Entries are indexed by the rateId of the MCS within the group; the TX
+ * times of the MCSs that are not valid in the group are zero.
+ *
+ * The TX times only depend on the group, the frame length, the frequency
+ * and the STBC setting of the PHY, so a single table is computed for all
+ * the managers sharing these parameters, and it is never modified once
+ * filled.
  */
-typedef std::vector<std::pair<Time, WifiMode> > TxTime;
+struct McsGroupTxTimes
+{
+  std::vector<WifiMode> modes; ///< MCS of each rate
+  // To accurately account for TX times, we separate the TX time of the first
+  // MPDU in an A-MPDU from the rest of the MPDUs.
+  std::vector<Time> txTimes; ///< rates transmit time table
+  std::vector<Time> firstMpduTxTimes; ///< rates first MPDU transmit time table
+};
 
 /**
  * Data structure to contain the information that defines a group.
- * It also contains the transmission times for all the MCS in the group.
+ * It also points to the transmission times for all the MCS in the group.
  * A group is a collection of MCS defined by the number of spatial streams,
  * if it uses or not Short Guard Interval, and the channel width used.
  */
@@ -50,11 +63,7 @@ struct McsGroup
   uint8_t chWidth; ///< channel width
   bool isVht; ///< is VHT?
   bool isSupported; ///< is supported?
-
-  // To accurately account for TX times, we separate the TX time of the first
-  // MPDU in an A-MPDU from the rest of the MPDUs.
-  TxTime ratesTxTimeTable; ///< rates transmit time table
-  TxTime ratesFirstMpduTxTimeTable; ///< rates MPDU transmit time table
+  const McsGroupTxTimes *txTimes; ///< shared rates transmit times, 0 if not supported
 };
 
 /**
@@ -195,6 +204,12 @@ static const uint8_t MAX_VHT_WIDTH = 160;        //!< Maximal channel width.
  * each interval. However, it samples less often the low rates and high
  * probability of error rates.
  *
+ * For simulations where rate control is not under study, the FastModeRates
+ * attribute enables a fast mode. Once an SNR is reported for a station
+ * (through its data frames or the frames received from it), only the
+ * FastModeRates fastest rates whose SNR threshold is below that SNR have
+ * their statistics updated, and no other rate is sampled.
+ *
  * When this rate control is configured but HT and VHT are not supported,
  * Minstrel-HT uses legacy Minstrel (minstrel-wifi-manager) for rate control.
  */
@@ -272,18 +287,30 @@ private:
   /// Obtain the TXtime saved in the group information.
   Time GetMpduTxTime (uint32_t groupId, WifiMode mode) const;
 
-  /// Save a TxTime to the vector of groups.
-  void AddMpduTxTime (uint32_t groupId, WifiMode mode, Time t);
-
   /// Obtain the TXtime saved in the group information.
   Time GetFirstMpduTxTime (uint32_t groupId, WifiMode mode) const;
 
-  /// Save a TxTime to the vector of groups.
-  void AddFirstMpduTxTime (uint32_t groupId, WifiMode mode, Time t);
+  /// Obtain the position of a mode in the TX times of a group.
+  uint8_t GetTxTimeIndex (uint32_t groupId, WifiMode mode) const;
+
+  /**
+   * Get the TX times of a group supported by the device, computing them
+   * if no manager with the same frame length and PHY settings did it yet.
+   *
+   * \param groupId the group
+   * \return the shared TX times of the group
+   */
+  const McsGroupTxTimes * GetSharedTxTimes (uint32_t groupId);
 
   /// Update the number of retries and reset accordingly.
   void UpdateRetry (MinstrelHtWifiRemoteStation *station);
 
+  /// Record the SNR reported for a station, in fast mode.
+  void UpdateSnr (MinstrelHtWifiRemoteStation *station, double snr);
+
+  /// Compute the SNR thresholds and the order of the rates used in fast mode.
+  void InitFastMode (void);
+
   /// Update the number of sample count variables.
   void UpdatePacketCounters (MinstrelHtWifiRemoteStation *station, uint8_t nSuccessfulMpdus, uint8_t nFailedMpdus);
 
@@ -308,6 +335,25 @@ private:
    */
   void UpdateStats (MinstrelHtWifiRemoteStation *station);
 
+  /**
+   * Update the statistics of a rate with the attempts made since the
+   * previous update.
+   *
+   * \param station the minstrel HT wifi remote station
+   * \param groupId the group of the rate
+   * \param rateId the rate within the group
+   */
+  void UpdateRateStats (MinstrelHtWifiRemoteStation *station, uint32_t groupId, uint32_t rateId);
+
+  /**
+   * Fast mode: update the statistics of the FastModeRates fastest rates
+   * supported by the station whose SNR threshold is below the last SNR
+   * reported. The rates never tried are assumed to succeed.
+   *
+   * \param station the minstrel HT wifi remote station
+   */
+  void UpdateFastModeStats (MinstrelHtWifiRemoteStation *station);
+
   /**
    * Initialize Minstrel Table.
    *
@@ -509,6 +555,11 @@ private:
 
   bool m_printStats;           //!< If statistics table should be printed.
 
+  uint32_t m_fastModeRates;    //!< Number of rates whose statistics are updated in fast mode, 0 if disabled.
+  double m_fastModeBer;        //!< BER used to compute the SNR thresholds of the rates in fast mode.
+  std::vector<uint32_t> m_fastModeOrder;     //!< Rates supported by the device, from the shortest TX time.
+  std::vector<double> m_fastModeThresholds;  //!< Minimum SNR of each rate, indexed by global rate index.
+
 
   MinstrelMcsGroups m_minstrelGroups;                 //!< Global array for groups information.
 
@@ -45,7 +45,7 @@ MpduAggregator::Deaggregate (Ptr<Packet> aggregatedPacket)
   DeaggregatedMpdus set;
 
   AmpduSubframeHeader hdr;
-  Ptr<Packet> extractedMpdu = Create<Packet> ();
+  Ptr<Packet> extractedMpdu;
   uint32_t maxSize = aggregatedPacket->GetSize ();
   uint16_t extractedLength;
   uint32_t padding;
@@ -55,12 +55,22 @@ MpduAggregator::Deaggregate (Ptr<Packet> aggregatedPacket)
     {
       deserialized += aggregatedPacket->RemoveHeader (hdr);
       extractedLength = hdr.GetLength ();
+      padding = (4 - (extractedLength % 4 )) % 4;
+
+      uint32_t remaining = aggregatedPacket->GetSize ();
+      if (remaining >= extractedLength && remaining - extractedLength <= padding)
+        {
+          //last subframe: slice the packet in place rather than copying it
+          aggregatedPacket->RemoveAtEnd (remaining - extractedLength);
+          std::pair<Ptr<Packet>, AmpduSubframeHeader> packetHdr (aggregatedPacket, hdr);
+          set.push_back (packetHdr);
+          break;
+        }
+
       extractedMpdu = aggregatedPacket->CreateFragment (0, static_cast<uint32_t> (extractedLength));
       aggregatedPacket->RemoveAtStart (extractedLength);
       deserialized += extractedLength;
 
-      padding = (4 - (extractedLength % 4 )) % 4;
-
       if (padding > 0 && deserialized < maxSize)
         {
           aggregatedPacket->RemoveAtStart (padding);
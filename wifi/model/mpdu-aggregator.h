@@ -73,10 +73,15 @@ public:
    *
    * Adds <i>packet</i> to <i>aggregatedPacket</i>. In concrete aggregator's implementation is
    * specified how and if <i>packet</i> can be added to <i>aggregatedPacket</i>.
+   *
+   * <i>aggregatedPacket</i> only accounts for the size of the A-MPDU: its content is
+   * zero-filled, the MPDUs being kept by the caller and given their A-MPDU subframe
+   * header by AddHeaderAndPad when they are sent.
    */
   virtual bool Aggregate (Ptr<const Packet> packet, Ptr<Packet> aggregatedPacket) const = 0;
   /**
-  * This method performs a VHT/HE single MPDU aggregation.
+  * This method performs a VHT/HE single MPDU aggregation. As for Aggregate,
+  * only the size of <i>packet</i> is added to <i>aggregatedPacket</i>.
   */
   virtual void AggregateSingleMpdu (Ptr<const Packet> packet, Ptr<Packet> aggregatedPacket) const = 0;
   /**
@@ -103,6 +108,8 @@ public:
   virtual uint32_t CalculatePadding (Ptr<const Packet> packet) const = 0;
   /**
    * Deaggregates an A-MPDU by removing the A-MPDU subframe header and padding.
+   * The last subframe is returned as <i>aggregatedPacket</i> itself, trimmed in place,
+   * so that a subframe received on its own is not copied.
    *
    * \param aggregatedPacket the aggregated packet
    * \return list of deaggragted packets and their A-MPDU subframe headers
@@ -68,7 +68,6 @@ bool
 MpduStandardAggregator::Aggregate (Ptr<const Packet> packet, Ptr<Packet> aggregatedPacket) const
 {
   NS_LOG_FUNCTION (this);
-  Ptr<Packet> currentPacket;
   AmpduSubframeHeader currentHdr;
 
   uint32_t padding = CalculatePadding (aggregatedPacket);
@@ -76,18 +75,9 @@ MpduStandardAggregator::Aggregate (Ptr<const Packet> packet, Ptr<Packet> aggrega
 
   if ((4 + packet->GetSize () + actualSize + padding) <= m_maxAmpduLength)
     {
-      if (padding)
-        {
-          Ptr<Packet> pad = Create<Packet> (padding);
-          aggregatedPacket->AddAtEnd (pad);
-        }
-      currentHdr.SetCrc (1);
-      currentHdr.SetSig ();
-      currentHdr.SetLength (packet->GetSize ());
-      currentPacket = packet->Copy ();
-
-      currentPacket->AddHeader (currentHdr);
-      aggregatedPacket->AddAtEnd (currentPacket);
+      //Only the room taken by the subframe is accounted for: the MPDU itself
+      //is not copied, it is delimited by AddHeaderAndPad when it is sent
+      aggregatedPacket->AddPaddingAtEnd (padding + currentHdr.GetSerializedSize () + packet->GetSize ());
       return true;
     }
   return false;
@@ -97,24 +87,10 @@ void
 MpduStandardAggregator::AggregateSingleMpdu (Ptr<const Packet> packet, Ptr<Packet> aggregatedPacket) const
 {
   NS_LOG_FUNCTION (this);
-  Ptr<Packet> currentPacket;
   AmpduSubframeHeader currentHdr;
 
   uint32_t padding = CalculatePadding (aggregatedPacket);
-  if (padding)
-    {
-      Ptr<Packet> pad = Create<Packet> (padding);
-      aggregatedPacket->AddAtEnd (pad);
-    }
-
-  currentHdr.SetEof (1);
-  currentHdr.SetCrc (1);
-  currentHdr.SetSig ();
-  currentHdr.SetLength (packet->GetSize ());
-  currentPacket = packet->Copy ();
-
-  currentPacket->AddHeader (currentHdr);
-  aggregatedPacket->AddAtEnd (currentPacket);
+  aggregatedPacket->AddPaddingAtEnd (padding + currentHdr.GetSerializedSize () + packet->GetSize ());
 }
 
 void
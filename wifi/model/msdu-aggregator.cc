@@ -44,7 +44,7 @@ MsduAggregator::Deaggregate (Ptr<Packet> aggregatedPacket)
   DeaggregatedMsdus set;
 
   AmsduSubframeHeader hdr;
-  Ptr<Packet> extractedMsdu = Create<Packet> ();
+  Ptr<Packet> extractedMsdu;
   uint32_t maxSize = aggregatedPacket->GetSize ();
   uint16_t extractedLength;
   uint32_t padding;
@@ -54,12 +54,23 @@ MsduAggregator::Deaggregate (Ptr<Packet> aggregatedPacket)
     {
       deserialized += aggregatedPacket->RemoveHeader (hdr);
       extractedLength = hdr.GetLength ();
+      padding = (4 - ((extractedLength + 14) % 4 )) % 4;
+
+      uint32_t remaining = aggregatedPacket->GetSize ();
+      if (remaining >= extractedLength && remaining - extractedLength <= padding)
+        {
+          //last subframe: hand the A-MSDU itself up, trimmed in place
+          aggregatedPacket->RemoveAtEnd (remaining - extractedLength);
+          std::pair<Ptr<Packet>, AmsduSubframeHeader> packetHdr (aggregatedPacket, hdr);
+          set.push_back (packetHdr);
+          break;
+        }
+
+      //the fragment shares the bytes of the A-MSDU, they are not copied
       extractedMsdu = aggregatedPacket->CreateFragment (0, static_cast<uint32_t> (extractedLength));
       aggregatedPacket->RemoveAtStart (extractedLength);
       deserialized += extractedLength;
 
-      padding = (4 - ((extractedLength + 14) % 4 )) % 4;
-
       if (padding > 0 && deserialized < maxSize)
         {
           aggregatedPacket->RemoveAtStart (padding);
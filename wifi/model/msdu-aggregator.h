@@ -77,6 +77,8 @@ public:
                           Mac48Address src, Mac48Address dest) const = 0;
 
   /**
+   * Deaggregates an A-MSDU. The MSDUs share the bytes of <i>aggregatedPacket</i>,
+   * the last one being <i>aggregatedPacket</i> itself once trimmed.
    *
    * \param aggregatedPacket the aggregated packet.
    * \returns DeaggregatedMsdus.
@@ -68,7 +68,7 @@ MsduStandardAggregator::Aggregate (Ptr<const Packet> packet, Ptr<Packet> aggrega
                                    Mac48Address src, Mac48Address dest) const
 {
   NS_LOG_FUNCTION (this);
-  Ptr<Packet> currentPacket;
+  Ptr<Packet> subframeHdr;
   AmsduSubframeHeader currentHdr;
 
   uint32_t padding = CalculatePadding (aggregatedPacket);
@@ -78,16 +78,18 @@ MsduStandardAggregator::Aggregate (Ptr<const Packet> packet, Ptr<Packet> aggrega
     {
       if (padding)
         {
-          Ptr<Packet> pad = Create<Packet> (padding);
-          aggregatedPacket->AddAtEnd (pad);
+          aggregatedPacket->AddPaddingAtEnd (padding);
         }
       currentHdr.SetDestinationAddr (dest);
       currentHdr.SetSourceAddr (src);
       currentHdr.SetLength (packet->GetSize ());
-      currentPacket = packet->Copy ();
 
-      currentPacket->AddHeader (currentHdr);
-      aggregatedPacket->AddAtEnd (currentPacket);
+      //Append the subframe header and the MSDU separately: adding the header
+      //to a copy of the MSDU would copy its bytes once more
+      subframeHdr = Create<Packet> ();
+      subframeHdr->AddHeader (currentHdr);
+      aggregatedPacket->AddAtEnd (subframeHdr);
+      aggregatedPacket->AddAtEnd (packet);
       return true;
     }
   return false;
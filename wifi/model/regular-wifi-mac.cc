@@ -25,6 +25,7 @@
 #include "mac-tx-middle.h"
 #include "mac-low.h"
 #include "dcf-manager.h"
+#include "wifi-mac-queue.h"
 #include "msdu-standard-aggregator.h"
 #include "mpdu-standard-aggregator.h"
 #include "ns3/simulator.h"
@@ -51,6 +52,8 @@ RegularWifiMac::RegularWifiMac ()
 
   m_txMiddle = Create<MacTxMiddle> ();
 
+  m_latencyStats = Create<WifiLatencyStats> ();
+
   m_low = CreateObject<MacLow> ();
   m_low->SetRxCallback (MakeCallback (&MacRxMiddle::Receive, m_rxMiddle));
 
@@ -64,6 +67,7 @@ RegularWifiMac::RegularWifiMac ()
   m_dca->SetTxOkCallback (MakeCallback (&RegularWifiMac::TxOk, this));
   m_dca->SetTxFailedCallback (MakeCallback (&RegularWifiMac::TxFailed, this));
   m_dca->SetTxDroppedCallback (MakeCallback (&RegularWifiMac::NotifyTxDrop, this));
+  m_dca->SetLatencyStats (m_latencyStats);
 
   //Construct the EDCAFs. The ordering is important - highest
   //priority (Table 9-1 UP-to-AC mapping; IEEE 802.11-2012) must be created
@@ -134,6 +138,8 @@ RegularWifiMac::InitializeMuMode ()
      m_dcaMu[i]->SetTxOkCallback (MakeCallback (&RegularWifiMac::TxOk, this));
      m_dcaMu[i]->SetTxFailedCallback (MakeCallback (&RegularWifiMac::TxFailed, this)); 
      m_dcaMu[i]->SetTxDroppedCallback (MakeCallback (&RegularWifiMac::NotifyTxDrop, this)); 
+     m_dcaMu[i]->SetLatencyStats (m_latencyStats);
+     m_dcaMu[i]->SetMuSource (m_dca->GetQueue ()); //infocom: RU transmitters dequeue data frames from the SU queue
 
      SetupMuEdcaQueue (AC_VO, i);
      SetupMuEdcaQueue (AC_VI, i);
@@ -180,6 +186,8 @@ RegularWifiMac::DoDispose ()
 
   m_phy = 0;
   m_stationManager = 0;
+  m_counters = 0;
+  m_latencyStats = 0;
 
   m_dca->Dispose ();
   m_dca = 0;
@@ -344,6 +352,49 @@ RegularWifiMac::GetMuWifiRemoteStationManager (uint32_t i) const
   return m_stationManagerMu[i];
 }
 
+void
+RegularWifiMac::SetCounters (Ptr<WifiDeviceCounters> counters)
+{
+  NS_LOG_FUNCTION (this);
+  m_counters = counters;
+  m_low->SetCounters (counters);
+  for (uint32_t i = 0; i < 9; i++)
+    {
+      m_lowMu[i]->SetCounters (counters);
+    }
+}
+
+uint64_t
+RegularWifiMac::GetNQueueDrops (void) const
+{
+  uint64_t drops = m_dca->GetQueue ()->GetNDropped ();
+  for (EdcaQueues::const_iterator i = m_edca.begin (); i != m_edca.end (); ++i)
+    {
+      drops += i->second->GetQueue ()->GetNDropped ();
+    }
+  for (uint32_t ru = 0; ru < 9; ru++)
+    {
+      drops += m_dcaMu[ru]->GetQueue ()->GetNDropped ();
+      for (EdcaQueues::const_iterator i = m_edcaMu[ru].begin (); i != m_edcaMu[ru].end (); ++i)
+        {
+          drops += i->second->GetQueue ()->GetNDropped ();
+        }
+    }
+  return drops;
+}
+
+WifiLatencyStats
+RegularWifiMac::GetLatencyStats (void) const
+{
+  return *m_latencyStats;
+}
+
+void
+RegularWifiMac::PrintLatencyStats (std::ostream &os) const
+{
+  m_latencyStats->Print (os);
+}
+
 HtCapabilities
 RegularWifiMac::GetHtCapabilities (void) const
 {
@@ -683,6 +734,7 @@ RegularWifiMac::SetupEdcaQueue (AcIndex ac)
   edca->SetTxOkCallback (MakeCallback (&RegularWifiMac::TxOk, this));
   edca->SetTxFailedCallback (MakeCallback (&RegularWifiMac::TxFailed, this));
   edca->SetTxDroppedCallback (MakeCallback (&RegularWifiMac::NotifyTxDrop, this));
+  edca->SetLatencyStats (m_latencyStats);
   edca->SetAccessCategory (ac);
   edca->CompleteConfig ();
 
@@ -705,8 +757,10 @@ RegularWifiMac::SetupMuEdcaQueue (AcIndex ac, uint32_t ru)
   edca->SetTxOkCallback (MakeCallback (&RegularWifiMac::TxOk, this));
   edca->SetTxFailedCallback (MakeCallback (&RegularWifiMac::TxFailed, this));
   edca->SetTxDroppedCallback (MakeCallback (&RegularWifiMac::NotifyTxDrop, this));
+  edca->SetLatencyStats (m_latencyStats);
   edca->SetAccessCategory (ac);
   edca->CompleteConfig ();
+  edca->SetMuSource (m_edca.find (ac)->second->GetQueue ()); //infocom: RU transmitters dequeue data frames from the SU queue
 
   m_edcaMu[ru].insert (std::make_pair (ac, edca));
   
@@ -1759,6 +1813,10 @@ void
 RegularWifiMac::TxFailed (const WifiMacHeader &hdr)
 {
   NS_LOG_FUNCTION (this << hdr);
+  if (m_counters != 0)
+    {
+      m_counters->txFailed++;
+    }
   m_txErrCallback (hdr);
 }
 
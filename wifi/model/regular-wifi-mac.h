@@ -24,6 +24,8 @@
 #include "wifi-mac.h"
 #include "dca-txop.h"
 #include "edca-txop-n.h"
+#include "wifi-device-counters.h"
+#include "wifi-latency-histogram.h"
 
 namespace ns3 {
 
@@ -240,6 +242,29 @@ public:
    */
   Ptr<WifiRemoteStationManager> GetWifiRemoteStationManager (void) const;
   Ptr<WifiRemoteStationManager> GetMuWifiRemoteStationManager (uint32_t i) const;
+  /**
+   * \param counters the counters of the device
+   *
+   * Make this MAC and its MacLows update <i>counters</i>.
+   */
+  void SetCounters (Ptr<WifiDeviceCounters> counters);
+  /**
+   * \return the number of frames dropped so far by the queues of this MAC,
+   *         see WifiMacQueue::GetNDropped
+   */
+  uint64_t GetNQueueDrops (void) const;
+  /**
+   * \return a snapshot of the latency histograms of the data MPDUs sent by
+   *         this MAC and acknowledged so far
+   */
+  WifiLatencyStats GetLatencyStats (void) const;
+  /**
+   * Print the count, mean, median, 99th percentile and max of the latency
+   * histograms of this MAC.
+   *
+   * \param os the output stream
+   */
+  void PrintLatencyStats (std::ostream &os) const;
   /**
    * Return the HT capability of the device.
    *
@@ -333,6 +358,8 @@ protected:
 
   Ptr<WifiRemoteStationManager> m_stationManager; //!< Remote station manager (rate control, RTS/CTS/fragmentation thresholds etc.)
   Ptr<WifiRemoteStationManager> m_stationManagerMu [9];
+  Ptr<WifiDeviceCounters> m_counters; //!< counters of the device, if any
+  Ptr<WifiLatencyStats> m_latencyStats; //!< latency histograms of the data MPDUs sent
 
   ForwardUpCallback m_forwardUp; //!< Callback to forward packet up the stack
   Callback<void> m_linkUp;       //!< Callback when a link is up
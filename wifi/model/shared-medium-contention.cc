@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "shared-medium-contention.h"
+#include "dcf-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SharedMediumContention");
+
+NS_OBJECT_ENSURE_REGISTERED (SharedMediumContention);
+
+TypeId
+SharedMediumContention::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SharedMediumContention")
+    .SetParent<Object> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<SharedMediumContention> ()
+  ;
+  return tid;
+}
+
+SharedMediumContention::SharedMediumContention ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SharedMediumContention::~SharedMediumContention ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SharedMediumContention::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+  m_expiries.clear ();
+  m_managers.clear ();
+  Object::DoDispose ();
+}
+
+void
+SharedMediumContention::Schedule (DcfManager *manager, Time delay)
+{
+  NS_LOG_FUNCTION (this << manager << delay);
+  NS_ASSERT (m_managers.find (manager) == m_managers.end ());
+  Expiries::iterator it = m_expiries.insert (std::make_pair (Simulator::Now () + delay, manager));
+  m_managers.insert (std::make_pair (manager, it));
+  Reschedule ();
+}
+
+void
+SharedMediumContention::Cancel (const DcfManager *manager)
+{
+  NS_LOG_FUNCTION (this << manager);
+  Managers::iterator it = m_managers.find (manager);
+  if (it != m_managers.end ())
+    {
+      m_expiries.erase (it->second);
+      m_managers.erase (it);
+      Reschedule ();
+    }
+}
+
+bool
+SharedMediumContention::IsScheduled (const DcfManager *manager) const
+{
+  return m_managers.find (manager) != m_managers.end ();
+}
+
+Time
+SharedMediumContention::GetDelayLeft (const DcfManager *manager) const
+{
+  Managers::const_iterator it = m_managers.find (manager);
+  NS_ASSERT (it != m_managers.end ());
+  return it->second->first - Simulator::Now ();
+}
+
+uint32_t
+SharedMediumContention::GetNPending (void) const
+{
+  return m_managers.size ();
+}
+
+void
+SharedMediumContention::Reschedule (void)
+{
+  if (m_expiries.empty ())
+    {
+      m_event.Cancel ();
+      return;
+    }
+  Time earliest = m_expiries.begin ()->first;
+  if (m_event.IsRunning () && m_eventTime == earliest)
+    {
+      return;
+    }
+  m_event.Cancel ();
+  m_eventTime = earliest;
+  m_event = Simulator::Schedule (earliest - Simulator::Now (), &SharedMediumContention::Expire, this);
+}
+
+void
+SharedMediumContention::Expire (void)
+{
+  NS_LOG_FUNCTION (this);
+  //Detach all the due managers first: their access timeout may register
+  //a new expiry
+  std::vector<DcfManager *> due;
+  while (!m_expiries.empty () && m_expiries.begin ()->first <= Simulator::Now ())
+    {
+      due.push_back (m_expiries.begin ()->second);
+      m_managers.erase (m_expiries.begin ()->second);
+      m_expiries.erase (m_expiries.begin ());
+    }
+  NS_LOG_DEBUG (due.size () << " backoff expiries at " << Simulator::Now ());
+  for (std::vector<DcfManager *>::const_iterator i = due.begin (); i != due.end (); i++)
+    {
+      (*i)->AccessTimeout ();
+    }
+  Reschedule ();
+}
+
+} //namespace ns3
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SHARED_MEDIUM_CONTENTION_H
+#define SHARED_MEDIUM_CONTENTION_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include <map>
+
+namespace ns3 {
+
+class DcfManager;
+
+/**
+ * \ingroup wifi
+ * \brief Backoff expiries of all the DcfManagers sharing a medium
+ *
+ * By default every DcfManager schedules its own access timeout, which is
+ * cancelled and scheduled again whenever the medium becomes busy. When
+ * hundreds of stations hear each other, each busy period thus costs one
+ * event per station.
+ *
+ * When a SharedMediumContention object is aggregated to a channel, the
+ * DcfManagers of the PHYs attached to that channel hand their backoff
+ * expiries to it instead. Expiries are kept sorted, and a single event,
+ * scheduled at the earliest one, runs the access timeout of every manager
+ * expiring at exactly that time, in the order their expiries were
+ * registered. Only the expiries with the same timestamp share an event:
+ * a busy period still costs each manager whose expiry moves a cancel and
+ * an insertion in the sorted expiries, but no longer a simulator event.
+ * Access is still granted by each DcfManager, so winners and collisions
+ * are the same as without this object.
+ *
+ * \code
+ *   Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+ *   channel->AggregateObject (CreateObject<SharedMediumContention> ());
+ * \endcode
+ *
+ * The object must be aggregated before the devices are installed.
+ */
+class SharedMediumContention : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  SharedMediumContention ();
+  virtual ~SharedMediumContention ();
+
+  /**
+   * \param manager the DcfManager whose backoff expires
+   * \param delay the delay until the backoff expires
+   *
+   * Run the access timeout of <i>manager</i> after <i>delay</i>. The
+   * manager must not have a pending expiry.
+   */
+  void Schedule (DcfManager *manager, Time delay);
+  /**
+   * \param manager the DcfManager
+   *
+   * Drop the pending expiry of <i>manager</i>, if any.
+   */
+  void Cancel (const DcfManager *manager);
+  /**
+   * \param manager the DcfManager
+   * \return true if <i>manager</i> has a pending expiry
+   */
+  bool IsScheduled (const DcfManager *manager) const;
+  /**
+   * \param manager the DcfManager
+   * \return the delay until the pending expiry of <i>manager</i>
+   */
+  Time GetDelayLeft (const DcfManager *manager) const;
+  /**
+   * \return the number of DcfManagers with a pending expiry
+   */
+  uint32_t GetNPending (void) const;
+
+
+private:
+  virtual void DoDispose (void);
+
+  /**
+   * Run the access timeouts that are due.
+   */
+  void Expire (void);
+  /**
+   * Make sure the event is scheduled at the earliest pending expiry.
+   */
+  void Reschedule (void);
+
+  /// pending expiries, sorted by time and then by registration order
+  typedef std::multimap<Time, DcfManager *> Expiries;
+  /// pending expiry of each manager
+  typedef std::map<const DcfManager *, Expiries::iterator> Managers;
+
+  Expiries m_expiries; //!< pending expiries
+  Managers m_managers; //!< pending expiry of each manager
+  EventId m_event;     //!< event at the earliest pending expiry
+  Time m_eventTime;    //!< time of m_event
+};
+
+} //namespace ns3
+
+#endif /* SHARED_MEDIUM_CONTENTION_H */
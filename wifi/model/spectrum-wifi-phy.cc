@@ -30,6 +30,7 @@
 #include "wifi-spectrum-signal-parameters.h"
 #include "wifi-utils.h"
 #include "ns3/simulator.h"
+#include "ns3/hot-path-profiler.h"
 
 namespace ns3 {
 
@@ -181,6 +182,7 @@ void
 SpectrumWifiPhy::StartRx (Ptr<SpectrumSignalParameters> rxParams)
 {
   NS_LOG_FUNCTION (this << rxParams);
+  NS_PROFILE_FUNCTION ("SpectrumWifiPhy::StartRx");
   Ptr<WifiSpectrumSignalParameters> temp = DynamicCast<WifiSpectrumSignalParameters> (rxParams);
   Time rxDuration = rxParams->duration;
   Ptr<SpectrumValue> receivedSignalPsd = rxParams->psd;
@@ -235,6 +237,22 @@ SpectrumWifiPhy::StartRx (Ptr<SpectrumSignalParameters> rxParams)
       return;
     }
 
+  if (IsInterBss (wifiRxParams->bssColor))
+    {
+      /*
+       * Inter-BSS PPDU: it is only interference for this BSS, so skip
+       * preamble processing. It sets CCA BUSY for its duration at or above
+       * the OBSS PD level, even below the CCA Mode 1 threshold.
+       */
+      NS_LOG_INFO ("Received inter-BSS Wi-Fi signal, color " << (uint16_t)wifiRxParams->bssColor);
+      m_interference.AddForeignSignal (rxDuration, rxPowerW);
+      if (rxPowerW >= DbmToW (GetObssPdLevel ()))
+        {
+          m_state->SwitchMaybeToCcaBusy (rxDuration);
+        }
+      return;
+    }
+
   NS_LOG_INFO ("Received Wi-Fi signal");
   Ptr<Packet> packet = wifiRxParams->packet->Copy ();
   StartReceivePreambleAndHeader (packet, rxPowerW, rxDuration);
@@ -319,6 +337,7 @@ SpectrumWifiPhy::StartTx (Ptr<Packet> packet, WifiTxVector txVector, Time txDura
   txParams->packet = packet;
   txParams->ruBits = GetRuBits ();
   txParams->muMode = GetMuMode ();
+  txParams->bssColor = txVector.GetBssColor ();
   NS_LOG_DEBUG ("Starting transmission with power " << WToDbm (txPowerWatts) << " dBm on channel " << (uint16_t) GetChannelNumber ());
   NS_LOG_DEBUG ("Starting transmission with integrated spectrum power " << WToDbm (Integral (*txPowerSpectrum)) << " dBm; spectrum model Uid: " << txPowerSpectrum->GetSpectrumModel ()->GetUid ());
   m_channel->StartTx (txParams);
@@ -24,6 +24,7 @@
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include "mac-low.h"
+#include <limits>
 
 /*
  * The state machine for this STA is:
@@ -56,6 +57,7 @@ bool StaWifiMac::m_bsrTx5 = false;
 bool StaWifiMac::m_bsrTx6 = false;
 bool StaWifiMac::m_bsrTx7 = false;
 bool StaWifiMac::m_bsrTx8 = false;
+StaWifiMac::DecodedTf StaWifiMac::m_decodedTf = { std::numeric_limits<uint64_t>::max (), MgtTFHeader () };
 
 TypeId
 StaWifiMac::GetTypeId (void)
@@ -360,6 +362,17 @@ StaWifiMac::SendProbeRequest (void)
                                              &StaWifiMac::ProbeRequestTimeout, this);
 }
 
+const MgtTFHeader &
+StaWifiMac::DecodeTf (Ptr<const Packet> packet)
+{
+  if (packet->GetUid () != m_decodedTf.uid)
+    {
+      packet->PeekHeader (m_decodedTf.tf);
+      m_decodedTf.uid = packet->GetUid ();
+    }
+  return m_decodedTf.tf;
+}
+
 uint32_t
 StaWifiMac::GetBSR (void)
 {
@@ -601,41 +614,38 @@ StaWifiMac::Enqueue (Ptr<const Packet> packet, Mac48Address to)
   hdr.SetDsTo ();
 
 
-  if (GetMuMode ())
+  /*
+   * infocom: the frame is queued once, in the SU queue. During a TF cycle
+   * the transmitter of the allocated RU dequeues it from there.
+   */
+  if (GetMuMode () || m_muModeToStart)
    {
      if (m_qosSupported)
       {
-        m_edcaMu[GetRuBits()][AC_BE]->Queue (packet, hdr);
+        m_edca[QosUtilsMapTidToAc (tid)]->QueueButDontSend (packet, hdr);
+        if (GetMuMode ())
+         {
+           m_edcaMu[GetRuBits ()][QosUtilsMapTidToAc (tid)]->StartAccessIfNeeded ();
+         }
       }
      else
       {
-        m_dcaMu[GetRuBits()]->Queue (packet, hdr);
+        m_dca->QueueButDontSend (packet, hdr);
+        if (GetMuMode ())
+         {
+           m_dcaMu[GetRuBits ()]->StartAccessIfNeeded ();
+         }
       }
    }
-  else if (m_muModeToStart)
-   {
-      if (m_qosSupported)
-       {
-        m_edcaMu[GetRuBits()][AC_BE]->QueueButDontSend (packet, hdr);
-       }
-      else
-       {
-         m_dcaMu[GetRuBits()]->QueueButDontSend (packet, hdr);
-       }
-   }
   else 
    {
-     for (uint32_t i = 0; i < 9; i++)
-      {
-        m_edcaMu[i][AC_BE]->QueueButDontSend (packet, hdr);
-      }
      if (m_qosSupported)
       {
-	m_dca->Queue (packet, hdr);
+        m_edca[QosUtilsMapTidToAc (tid)]->Queue (packet, hdr);
       }
      else
       {
-        m_edca[QosUtilsMapTidToAc (tid)]->Queue (packet, hdr);
+        m_dca->Queue (packet, hdr);
       }
    }
   
@@ -715,14 +725,10 @@ StaWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
        MgtTFBeaconHeader beacon;
        packet->RemoveHeader (beacon);
        SetTfDuration(beacon.GetTfDuration ());
-       RegularWifiMac::RUAllocations alloc = beacon.GetRUAllocations ();
-       for (RegularWifiMac::RUAllocations::const_iterator it = alloc.begin (); it != alloc.end (); it++)
+       uint32_t ru;
+       if (beacon.GetUserInfo ().Lookup (GetAddress (), &ru))
         {
-          if (it->first == GetAddress ())
-           {
-	     //std::cout<<"RU of "<<GetAddress () << " set to "<<it->second <<"\ttime = "<<Now ().GetMicroSeconds ()<< std::endl;
-             SetRuBits (it->second);
-           }
+          SetRuBits (ru);
         }
     }
   else if (hdr->IsBsrAck ())
@@ -730,6 +736,10 @@ StaWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
         MgtBsrAckHeader bsrAck;
         packet->RemoveHeader (bsrAck);
         m_bsrAckRecvd = true;
+        if (m_counters != 0)
+          {
+            m_counters->bsrSuccesses++;
+          }
         SetMuMode (1);
         /*
          * If BSR ack was received, then my BSR transmission was succesful
@@ -746,15 +756,17 @@ StaWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
   else if (hdr->IsTF ())
     {
       ResetBsrTx ();
+      if (m_counters != 0)
+        {
+          m_counters->tfs++;
+        }
       m_updatedOnce = false;
       m_lastTfTxStart = m_low->CalculateTfBeaconDuration (packet, *hdr); // hack
-      MgtTFHeader tf;
-      packet->RemoveHeader (tf);
+      const MgtTFHeader &tf = DecodeTf (packet);
 
-      RegularWifiMac::RUAllocations alloc = tf.GetRUAllocations ();
       uint32_t ulFlag = tf.GetUplinkFlag ();
       m_muUlFlag = ulFlag;
-      SetTfDuration(tf.GetTfDuration ());
+      SetTfDuration (tf.GetTfDuration ());
       m_muDlModeEnd = GetTfDuration () * GetSlot () - m_lastTfTxStart;  
       m_dcfManager->NotifyMaybeCcaBusyStartNow (m_muDlModeEnd); // Notify the DcfManager of 20 MHz PHY that the channel is busy until OFDMA mode ends
       m_muModeExpireEvent = Simulator::Schedule (m_muDlModeEnd, &StaWifiMac::StopMuMode, this); 
@@ -777,6 +789,10 @@ StaWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
           */
          if (!m_bsrAckRecvd)
           {
+            if (m_counters != 0)
+              {
+                m_counters->bsrCollisions++;
+              }
             SetTfCw (2 * GetTfCw ());
             if (GetTfCw () > GetTfCwMax ())
              {
@@ -790,24 +806,27 @@ StaWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
          m_bsrAckRecvd = false;
        }
 
-      for (RegularWifiMac::RUAllocations::const_iterator it = alloc.begin (); it != alloc.end (); it++)
+      /*
+       * Only two entries of the shared allocation matter to this STA:
+       * its own scheduled RU and the random access (broadcast) entry.
+       */
+      uint32_t ru;
+      if (tf.GetUserInfo ().Lookup (GetAddress (), &ru))
        {
-         if (it->first == GetAddress ())
+         if (ulFlag)
+           {
+             SetMuMode (1);
+             SetRuBits (ru);
+             PrepareForTx ();
+             Simulator::Schedule(MicroSeconds (17), &DcfManager::NotifyMaybeCcaBusyStartNow, m_dcfManagerMu[GetRuBits ()], Seconds (1));
+             return;
+           }
+         else
            {
-             if (ulFlag)
-               {
-                 SetMuMode (1);
-                 SetRuBits (it->second);
-		 PrepareForTx ();
-                 Simulator::Schedule(MicroSeconds (17), &DcfManager::NotifyMaybeCcaBusyStartNow, m_dcfManagerMu[GetRuBits ()], Seconds (1));
-                 return;
-               }
-             else
-               {
-                 NS_LOG_UNCOND("Received Trigger Frame for DL, time = "<<Simulator::Now ().GetMicroSeconds ());
-               }
+             NS_LOG_UNCOND("Received Trigger Frame for DL, time = "<<Simulator::Now ().GetMicroSeconds ());
            }
-	  if (it->first == Mac48Address::GetBroadcast ())
+       }
+      if (tf.GetUserInfo ().Lookup (Mac48Address::GetBroadcast (), &ru))
            {
              std::cout<<"STA "<<m_phy->GetDevice ()->GetNode ()->GetId ()<<"\tm_noSlots =  "<<m_noSlots << "\tSelected RU = "<<GetRuBits ()<<"\tTfCw = "<<GetTfCw ()<< "\ttime = "<< Simulator::Now ().GetMicroSeconds ()<<std::endl;
              m_lastTfRespRecv = Now ();
@@ -831,7 +850,6 @@ StaWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
                */
               Simulator::Schedule ((GetMaxTfSlots ()) * GetSlot () + GetSifs (), &StaWifiMac::CancelExpiredEvents, this);
             }
-       }
     
       
     }
@@ -1341,6 +1359,11 @@ StaWifiMac::SetEdcaParameters (AcIndex ac, uint8_t cwMin, uint8_t cwMax, uint8_t
 void
 StaWifiMac::PrepareForTx (void)
 {
+  m_dcaMu[GetRuBits ()]->SetMuDestination (GetBssid ());
+  for (EdcaQueues::const_iterator i = m_edcaMu[GetRuBits ()].begin (); i != m_edcaMu[GetRuBits ()].end (); ++i)
+   {
+     i->second->SetMuDestination (GetBssid ());
+   }
   for (uint32_t ac = 0; ac < 8; ac++)
    {
      m_edcaMu[GetRuBits ()][QosUtilsMapTidToAc(ac)]->SetAifsn (0);
@@ -26,6 +26,7 @@
 #include "regular-wifi-mac.h"
 #include "supported-rates.h"
 #include "capability-information.h"
+#include "mgt-headers.h"
 
 namespace ns3  {
 
@@ -215,6 +216,27 @@ private:
    */
   CapabilityInformation GetCapabilities (void) const;
 
+  /**
+   * infocom: a TF is broadcast to all the STAs of the BSS. The first STA
+   * that receives a copy decodes it; the other STAs receiving the same
+   * packet (same uid) share the decoded fields read-only.
+   */
+  struct DecodedTf
+  {
+    uint64_t uid;                         //!< uid of the decoded TF packet
+    MgtTFHeader tf;                       //!< the decoded TF header
+  };
+  /**
+   * Return the decoded header of a received TF, decoding it only if it
+   * is not the TF decoded last.
+   *
+   * \param packet the received TF, without its MAC header
+   *
+   * \return the shared decoded TF header
+   */
+  static const MgtTFHeader & DecodeTf (Ptr<const Packet> packet);
+  static DecodedTf m_decodedTf; //!< last decoded TF, shared by all STAs
+
   MacState m_state;            ///< MAC state
   uint32_t m_noSlots;
   Time m_probeRequestTimeout;  ///< probe request timeout
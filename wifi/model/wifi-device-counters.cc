@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "wifi-device-counters.h"
+#include "wifi-mac-header.h"
+#include "qos-utils.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+namespace {
+
+/**
+ * \param hdr the MAC header of a data frame
+ * \return the access category the frame is counted under
+ */
+uint32_t
+GetCountersAc (const WifiMacHeader &hdr)
+{
+  if (hdr.IsQosData ())
+    {
+      return QosUtilsMapTidToAc (hdr.GetQosTid ());
+    }
+  return AC_BE_NQOS;
+}
+
+} //anonymous namespace
+
+WifiDeviceCounters::WifiDeviceCounters ()
+  : txRetries (0),
+    txFailed (0),
+    ampdus (0),
+    ampduMpdus (0),
+    maxAmpduMpdus (0),
+    tfs (0),
+    bsrSuccesses (0),
+    bsrCollisions (0),
+    queueDrops (0)
+{
+  for (uint32_t ru = 0; ru < N_RUS; ru++)
+    {
+      for (uint32_t ac = 0; ac < N_ACS; ac++)
+        {
+          txMpdus[ru][ac] = 0;
+          txBytes[ru][ac] = 0;
+          rxMpdus[ru][ac] = 0;
+          rxBytes[ru][ac] = 0;
+        }
+    }
+}
+
+void
+WifiDeviceCounters::NotifyTxMpdu (uint32_t ru, const WifiMacHeader &hdr, uint32_t size)
+{
+  NS_ASSERT (ru < N_RUS);
+  uint32_t ac = GetCountersAc (hdr);
+  txMpdus[ru][ac]++;
+  txBytes[ru][ac] += size;
+  if (hdr.IsRetry ())
+    {
+      txRetries++;
+    }
+}
+
+void
+WifiDeviceCounters::NotifyRxMpdu (uint32_t ru, const WifiMacHeader &hdr, uint32_t size)
+{
+  NS_ASSERT (ru < N_RUS);
+  uint32_t ac = GetCountersAc (hdr);
+  rxMpdus[ru][ac]++;
+  rxBytes[ru][ac] += size;
+}
+
+void
+WifiDeviceCounters::NotifyAmpdu (uint32_t nMpdus)
+{
+  ampdus++;
+  ampduMpdus += nMpdus;
+  if (nMpdus > maxAmpduMpdus)
+    {
+      maxAmpduMpdus = nMpdus;
+    }
+}
+
+uint64_t
+WifiDeviceCounters::GetTotalTxMpdus (void) const
+{
+  uint64_t total = 0;
+  for (uint32_t ru = 0; ru < N_RUS; ru++)
+    {
+      for (uint32_t ac = 0; ac < N_ACS; ac++)
+        {
+          total += txMpdus[ru][ac];
+        }
+    }
+  return total;
+}
+
+uint64_t
+WifiDeviceCounters::GetTotalTxBytes (void) const
+{
+  uint64_t total = 0;
+  for (uint32_t ru = 0; ru < N_RUS; ru++)
+    {
+      for (uint32_t ac = 0; ac < N_ACS; ac++)
+        {
+          total += txBytes[ru][ac];
+        }
+    }
+  return total;
+}
+
+uint64_t
+WifiDeviceCounters::GetTotalRxMpdus (void) const
+{
+  uint64_t total = 0;
+  for (uint32_t ru = 0; ru < N_RUS; ru++)
+    {
+      for (uint32_t ac = 0; ac < N_ACS; ac++)
+        {
+          total += rxMpdus[ru][ac];
+        }
+    }
+  return total;
+}
+
+uint64_t
+WifiDeviceCounters::GetTotalRxBytes (void) const
+{
+  uint64_t total = 0;
+  for (uint32_t ru = 0; ru < N_RUS; ru++)
+    {
+      for (uint32_t ac = 0; ac < N_ACS; ac++)
+        {
+          total += rxBytes[ru][ac];
+        }
+    }
+  return total;
+}
+
+void
+WifiDeviceCounters::Print (std::ostream &os) const
+{
+  static const char *acNames[N_ACS] = {"BE", "BK", "VI", "VO", "BE_NQOS"};
+  for (uint32_t ru = 0; ru < N_RUS; ru++)
+    {
+      for (uint32_t ac = 0; ac < N_ACS; ac++)
+        {
+          if (txMpdus[ru][ac] == 0 && rxMpdus[ru][ac] == 0)
+            {
+              continue;
+            }
+          if (ru == FULL_CHANNEL)
+            {
+              os << "channel";
+            }
+          else
+            {
+              os << "ru " << ru;
+            }
+          os << " " << acNames[ac]
+             << " tx " << txMpdus[ru][ac] << " MPDUs " << txBytes[ru][ac] << " bytes"
+             << " rx " << rxMpdus[ru][ac] << " MPDUs " << rxBytes[ru][ac] << " bytes"
+             << std::endl;
+        }
+    }
+  os << "retries " << txRetries
+     << " failed " << txFailed
+     << " A-MPDUs " << ampdus << " (" << ampduMpdus << " MPDUs, max " << maxAmpduMpdus << ")"
+     << " TFs " << tfs
+     << " BSR successes " << bsrSuccesses
+     << " BSR collisions " << bsrCollisions
+     << " queue drops " << queueDrops
+     << std::endl;
+}
+
+std::ostream &
+operator << (std::ostream &os, const WifiDeviceCounters &counters)
+{
+  counters.Print (os);
+  return os;
+}
+
+} //namespace ns3
@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WIFI_DEVICE_COUNTERS_H
+#define WIFI_DEVICE_COUNTERS_H
+
+#include "ns3/simple-ref-count.h"
+#include <ostream>
+
+namespace ns3 {
+
+class WifiMacHeader;
+
+/**
+ * \ingroup wifi
+ * \brief MAC counters of a WifiNetDevice
+ *
+ * infocom: the MAC and the MacLow of the full channel and of every RU
+ * update these counters with plain increments, so that the KPIs of a run
+ * can be read at its end without connecting any trace source and without
+ * copying packets. Data MPDUs are counted per RU, the full channel being
+ * the last RU index, and per access category, non-QoS data frames being
+ * counted under AC_BE_NQOS. Sizes are MPDU sizes, including the MAC header
+ * and the FCS.
+ *
+ * A snapshot of the counters of a device is obtained with
+ * WifiNetDevice::GetCounters, or for a set of devices with
+ * WifiHelper::GetCounters. Counters are never reset: the counts over a
+ * period are the difference between two snapshots.
+ */
+class WifiDeviceCounters : public SimpleRefCount<WifiDeviceCounters>
+{
+public:
+  /// number of RU indices: the 9 RUs, then the full channel
+  static const uint32_t N_RUS = 10;
+  /// RU index of the full channel
+  static const uint32_t FULL_CHANNEL = 9;
+  /// number of access categories, including AC_BE_NQOS
+  static const uint32_t N_ACS = 5;
+
+  WifiDeviceCounters ();
+
+  /**
+   * Count a data MPDU passed to the PHY.
+   *
+   * \param ru the RU index
+   * \param hdr the MAC header of the MPDU
+   * \param size the size of the MPDU
+   */
+  void NotifyTxMpdu (uint32_t ru, const WifiMacHeader &hdr, uint32_t size);
+  /**
+   * Count a data MPDU received from the PHY and addressed to the device.
+   *
+   * \param ru the RU index
+   * \param hdr the MAC header of the MPDU
+   * \param size the size of the MPDU
+   */
+  void NotifyRxMpdu (uint32_t ru, const WifiMacHeader &hdr, uint32_t size);
+  /**
+   * Count an A-MPDU passed to the PHY, S-MPDUs included.
+   *
+   * \param nMpdus the number of MPDUs in the A-MPDU
+   */
+  void NotifyAmpdu (uint32_t nMpdus);
+
+  /**
+   * \return the number of data MPDUs transmitted over all RUs and ACs
+   */
+  uint64_t GetTotalTxMpdus (void) const;
+  /**
+   * \return the number of data bytes transmitted over all RUs and ACs
+   */
+  uint64_t GetTotalTxBytes (void) const;
+  /**
+   * \return the number of data MPDUs received over all RUs and ACs
+   */
+  uint64_t GetTotalRxMpdus (void) const;
+  /**
+   * \return the number of data bytes received over all RUs and ACs
+   */
+  uint64_t GetTotalRxBytes (void) const;
+
+  /**
+   * Print the counters that are not zero.
+   *
+   * \param os the output stream
+   */
+  void Print (std::ostream &os) const;
+
+  uint64_t txMpdus[N_RUS][N_ACS]; //!< data MPDUs transmitted, per RU and AC
+  uint64_t txBytes[N_RUS][N_ACS]; //!< data bytes transmitted, per RU and AC
+  uint64_t rxMpdus[N_RUS][N_ACS]; //!< data MPDUs received, per RU and AC
+  uint64_t rxBytes[N_RUS][N_ACS]; //!< data bytes received, per RU and AC
+  uint64_t txRetries;             //!< data MPDUs transmitted with the Retry bit set
+  uint64_t txFailed;              //!< frames discarded after their last retry
+  uint64_t ampdus;                //!< A-MPDUs transmitted
+  uint64_t ampduMpdus;            //!< MPDUs transmitted in A-MPDUs
+  uint32_t maxAmpduMpdus;         //!< MPDUs in the largest A-MPDU transmitted
+  uint64_t tfs;                   //!< TFs transmitted (AP) or received (STA)
+  uint64_t bsrSuccesses;          //!< BSRs received (AP) or acknowledged (STA)
+  uint64_t bsrCollisions;         //!< TF cycles whose BSR was not acknowledged (STA)
+  uint64_t queueDrops;            //!< frames dropped by the MAC queues, see WifiNetDevice::GetCounters
+};
+
+/**
+ * \param os the output stream
+ * \param counters the counters
+ * \return the output stream
+ */
+std::ostream & operator << (std::ostream &os, const WifiDeviceCounters &counters);
+
+} //namespace ns3
+
+#endif /* WIFI_DEVICE_COUNTERS_H */
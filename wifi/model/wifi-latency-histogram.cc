@@ -0,0 +1,181 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "wifi-latency-histogram.h"
+#include "ns3/simulator.h"
+#include "ns3/assert.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+WifiLatencyHistogram::WifiLatencyHistogram ()
+  : m_count (0),
+    m_sum (Seconds (0)),
+    m_max (Seconds (0))
+{
+  for (uint32_t i = 0; i < N_BUCKETS; i++)
+    {
+      m_buckets[i] = 0;
+    }
+}
+
+void
+WifiLatencyHistogram::Add (Time latency)
+{
+  m_buckets[GetBucket (latency)]++;
+  m_count++;
+  m_sum += latency;
+  if (latency > m_max)
+    {
+      m_max = latency;
+    }
+}
+
+uint64_t
+WifiLatencyHistogram::GetCount (void) const
+{
+  return m_count;
+}
+
+Time
+WifiLatencyHistogram::GetMean (void) const
+{
+  if (m_count == 0)
+    {
+      return Seconds (0);
+    }
+  return NanoSeconds (m_sum.GetNanoSeconds () / static_cast<int64_t> (m_count));
+}
+
+Time
+WifiLatencyHistogram::GetMax (void) const
+{
+  return m_max;
+}
+
+Time
+WifiLatencyHistogram::GetPercentile (double p) const
+{
+  NS_ASSERT (p >= 0 && p <= 100);
+  if (m_count == 0)
+    {
+      return Seconds (0);
+    }
+  uint64_t rank = static_cast<uint64_t> (std::ceil (p / 100 * m_count));
+  if (rank == 0)
+    {
+      rank = 1;
+    }
+  uint64_t cumulated = 0;
+  for (uint32_t i = 0; i < N_BUCKETS; i++)
+    {
+      cumulated += m_buckets[i];
+      if (cumulated >= rank)
+        {
+          return std::min (GetBucketUpperBound (i), m_max);
+        }
+    }
+  return m_max;
+}
+
+uint64_t
+WifiLatencyHistogram::GetBucketCount (uint32_t i) const
+{
+  NS_ASSERT (i < N_BUCKETS);
+  return m_buckets[i];
+}
+
+Time
+WifiLatencyHistogram::GetBucketUpperBound (uint32_t i)
+{
+  NS_ASSERT (i < N_BUCKETS);
+  if (i == N_BUCKETS - 1)
+    {
+      return Time::Max ();
+    }
+  double ns = 1000 * std::pow (2.0, static_cast<double> (i) / BUCKETS_PER_OCTAVE);
+  return NanoSeconds (static_cast<int64_t> (std::floor (ns + 0.5)));
+}
+
+uint32_t
+WifiLatencyHistogram::GetBucket (Time latency)
+{
+  int64_t ns = latency.GetNanoSeconds ();
+  if (ns < 1000)
+    {
+      return 0;
+    }
+  double octaves = std::log (ns / 1000.0) / std::log (2.0);
+  uint32_t i = 1 + static_cast<uint32_t> (std::floor (octaves * BUCKETS_PER_OCTAVE));
+  return std::min (i, N_BUCKETS - 1);
+}
+
+void
+WifiLatencyHistogram::Print (std::ostream &os) const
+{
+  os << "n " << m_count
+     << " mean " << GetMean ().GetMicroSeconds () << "us"
+     << " p50 " << GetPercentile (50).GetMicroSeconds () << "us"
+     << " p99 " << GetPercentile (99).GetMicroSeconds () << "us"
+     << " max " << m_max.GetMicroSeconds () << "us";
+}
+
+void
+WifiLatencyStats::NotifyAcked (Time enqueued, Time accessRequested, Time accessGranted, Time txStarted)
+{
+  Time now = Simulator::Now ();
+  Time accessStart = std::max (enqueued, accessRequested);
+  Time accessDelay = Seconds (0);
+  if (accessGranted > accessStart)
+    {
+      accessDelay = accessGranted - accessStart;
+    }
+  Time airDelay = now - txStarted;
+  Time totalDelay = now - enqueued;
+  Time queueingDelay = totalDelay - accessDelay - airDelay;
+  if (queueingDelay.IsStrictlyNegative ())
+    {
+      queueingDelay = Seconds (0);
+    }
+  queueing.Add (queueingDelay);
+  access.Add (accessDelay);
+  airTime.Add (airDelay);
+  total.Add (totalDelay);
+}
+
+void
+WifiLatencyStats::Print (std::ostream &os) const
+{
+  os << "queueing ";
+  queueing.Print (os);
+  os << std::endl << "access ";
+  access.Print (os);
+  os << std::endl << "air time ";
+  airTime.Print (os);
+  os << std::endl << "total ";
+  total.Print (os);
+  os << std::endl;
+}
+
+std::ostream &
+operator << (std::ostream &os, const WifiLatencyStats &stats)
+{
+  stats.Print (os);
+  return os;
+}
+
+} //namespace ns3
@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WIFI_LATENCY_HISTOGRAM_H
+#define WIFI_LATENCY_HISTOGRAM_H
+
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief Histogram of latencies with fixed log-scale buckets
+ *
+ * The first bucket holds the latencies below 1 us. The next ones split
+ * every octave from 1 us on into BUCKETS_PER_OCTAVE buckets, and the last
+ * one holds the latencies above 2^OCTAVES us (about two minutes). The
+ * memory used is constant, and percentiles are accurate to a bucket,
+ * i.e., to about 19%.
+ */
+class WifiLatencyHistogram
+{
+public:
+  /// number of buckets per octave
+  static const uint32_t BUCKETS_PER_OCTAVE = 4;
+  /// number of octaves covered from 1 us on
+  static const uint32_t OCTAVES = 27;
+  /// number of buckets, including the first and the last ones
+  static const uint32_t N_BUCKETS = OCTAVES * BUCKETS_PER_OCTAVE + 2;
+
+  WifiLatencyHistogram ();
+
+  /**
+   * \param latency the latency to add
+   */
+  void Add (Time latency);
+
+  /**
+   * \return the number of latencies added
+   */
+  uint64_t GetCount (void) const;
+  /**
+   * \return the mean of the latencies added, or zero if none
+   */
+  Time GetMean (void) const;
+  /**
+   * \return the largest latency added, or zero if none
+   */
+  Time GetMax (void) const;
+  /**
+   * \param p the percentile, between 0 and 100
+   * \return the upper bound of the bucket that holds the <i>p</i>th
+   *         percentile, or the largest latency if it is lower, or zero if
+   *         no latency was added
+   */
+  Time GetPercentile (double p) const;
+  /**
+   * \param i the bucket index
+   * \return the number of latencies in bucket <i>i</i>
+   */
+  uint64_t GetBucketCount (uint32_t i) const;
+  /**
+   * \param i the bucket index
+   * \return the upper bound (excluded) of bucket <i>i</i>
+   */
+  static Time GetBucketUpperBound (uint32_t i);
+  /**
+   * \param latency a latency
+   * \return the index of the bucket that holds <i>latency</i>
+   */
+  static uint32_t GetBucket (Time latency);
+
+  /**
+   * Print the count, mean, median, 99th percentile and max.
+   *
+   * \param os the output stream
+   */
+  void Print (std::ostream &os) const;
+
+
+private:
+  uint64_t m_buckets[N_BUCKETS]; //!< number of latencies, per bucket
+  uint64_t m_count;              //!< number of latencies
+  Time m_sum;                    //!< sum of the latencies
+  Time m_max;                    //!< largest latency
+};
+
+/**
+ * \ingroup wifi
+ * \brief Latency histograms of the data MPDUs sent by a device
+ *
+ * infocom: when a data MPDU is acknowledged, by an Ack or in a Block Ack,
+ * its latency since it was enqueued is split into:
+ * - access: the time spent by the last channel access that carried it
+ *   (contention on the full channel, OBO and TF wait on an RU), counted
+ *   from the access request or from the enqueue if it came later;
+ * - air time: the time from the start of the frame exchange that carried
+ *   it (RTS/CTS included) to the Ack or Block Ack;
+ * - queueing: the rest, i.e., the time spent behind other frames and in
+ *   earlier failed attempts.
+ *
+ * Only the exchange that got the MPDU acknowledged is known: the access
+ * and air time of a retransmitted MPDU are those of its last attempt (for
+ * a Block Ack, of the exchange carrying the Block Ack or the BAR), and the
+ * access and air time of its failed attempts are counted as queueing.
+ *
+ * The total latency is recorded as well. Memory is constant per device.
+ */
+class WifiLatencyStats : public SimpleRefCount<WifiLatencyStats>
+{
+public:
+  /**
+   * Record the latencies of an MPDU acknowledged now.
+   *
+   * \param enqueued the time the MPDU was enqueued
+   * \param accessRequested the time the last channel access was requested
+   * \param accessGranted the time the last channel access was granted
+   * \param txStarted the time the frame exchange carrying the MPDU started
+   */
+  void NotifyAcked (Time enqueued, Time accessRequested, Time accessGranted, Time txStarted);
+
+  /**
+   * Print one line per histogram.
+   *
+   * \param os the output stream
+   */
+  void Print (std::ostream &os) const;
+
+  WifiLatencyHistogram queueing; //!< queueing latencies
+  WifiLatencyHistogram access;   //!< channel access latencies
+  WifiLatencyHistogram airTime;  //!< air time latencies
+  WifiLatencyHistogram total;    //!< enqueue to Ack latencies
+};
+
+/**
+ * \param os the output stream
+ * \param stats the latency histograms
+ * \return the output stream
+ */
+std::ostream & operator << (std::ostream &os, const WifiLatencyStats &stats);
+
+} //namespace ns3
+
+#endif /* WIFI_LATENCY_HISTOGRAM_H */
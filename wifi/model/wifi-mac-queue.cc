@@ -25,13 +25,89 @@
 #include "ns3/uinteger.h"
 #include "ns3/enum.h"
 #include "ns3/assert.h"
+#include "ns3/abort.h"
 #include "wifi-mac-queue.h"
 #include "qos-blocked-destinations.h"
+#include <algorithm>
+#include <vector>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("WifiMacQueue");
 
+namespace {
+
+/// Number of WifiMacQueueItem carved out of each slab
+const std::size_t ITEM_SLAB_SIZE = 64;
+
+/// Memory of the WifiMacQueueItem of the current simulation
+struct ItemPool
+{
+  std::vector<void *> freeList; //!< free items
+  std::vector<void *> slabs;    //!< slabs the items are carved out of
+  uint64_t nLive;               //!< number of items in use, pooled or not
+  bool enabled;                 //!< whether new items are taken from the pool
+  bool releaseScheduled;        //!< whether the release is scheduled at Simulator::Destroy
+  bool releasePending;          //!< whether the slabs are released when the last item is deleted
+};
+
+/**
+ * The pool is never destroyed, so that items released late during
+ * program exit can still be returned to it.
+ *
+ * \return the pool of WifiMacQueueItem memory
+ */
+ItemPool &
+GetItemPool (void)
+{
+  static ItemPool *pool = 0;
+  if (pool == 0)
+    {
+      pool = new ItemPool ();
+      pool->nLive = 0;
+      pool->enabled = true;
+      pool->releaseScheduled = false;
+      pool->releasePending = false;
+    }
+  return *pool;
+}
+
+/// Free the slabs of the pool, which must hold no item in use
+void
+FreeItemSlabs (void)
+{
+  ItemPool &pool = GetItemPool ();
+  NS_ASSERT (pool.nLive == 0);
+  std::vector<void *> ().swap (pool.freeList);
+  for (std::vector<void *>::const_iterator i = pool.slabs.begin (); i != pool.slabs.end (); i++)
+    {
+      ::operator delete (*i);
+    }
+  std::vector<void *> ().swap (pool.slabs);
+  pool.releasePending = false;
+}
+
+/**
+ * Run at Simulator::Destroy: free the slabs of the simulation, or as soon
+ * as the items still referenced after the destruction are deleted.
+ */
+void
+ReleaseItemPool (void)
+{
+  ItemPool &pool = GetItemPool ();
+  pool.releaseScheduled = false;
+  if (pool.nLive == 0)
+    {
+      FreeItemSlabs ();
+    }
+  else
+    {
+      pool.releasePending = true;
+    }
+}
+
+} //anonymous namespace
+
 WifiMacQueueItem::WifiMacQueueItem (Ptr<const Packet> p, const WifiMacHeader & header)
   : m_packet (p),
     m_header (header),
@@ -39,6 +115,13 @@ WifiMacQueueItem::WifiMacQueueItem (Ptr<const Packet> p, const WifiMacHeader & h
 {
 }
 
+WifiMacQueueItem::WifiMacQueueItem (Ptr<const Packet> p, const WifiMacHeader & header, Time tstamp)
+  : m_packet (p),
+    m_header (header),
+    m_tstamp (tstamp)
+{
+}
+
 WifiMacQueueItem::~WifiMacQueueItem ()
 {
 }
@@ -85,6 +168,79 @@ WifiMacQueueItem::GetSize (void) const
   return m_packet->GetSize () + m_header.GetSerializedSize ();
 }
 
+void *
+WifiMacQueueItem::operator new (std::size_t size)
+{
+  g_nItemAllocations++;
+  ItemPool &pool = GetItemPool ();
+  pool.nLive++;
+  if (size != sizeof (WifiMacQueueItem) || !pool.enabled)
+    {
+      g_nItemHeapAllocations++;
+      return ::operator new (size);
+    }
+  if (pool.freeList.empty ())
+    {
+      g_nItemHeapAllocations++;
+      uint8_t *slab = static_cast<uint8_t *> (::operator new (size * ITEM_SLAB_SIZE));
+      pool.slabs.push_back (slab);
+      for (std::size_t i = ITEM_SLAB_SIZE; i > 0; i--)
+        {
+          pool.freeList.push_back (slab + (i - 1) * size);
+        }
+      if (!pool.releaseScheduled)
+        {
+          pool.releaseScheduled = true;
+          Simulator::ScheduleDestroy (&ReleaseItemPool);
+        }
+    }
+  void *p = pool.freeList.back ();
+  pool.freeList.pop_back ();
+  return p;
+}
+
+void
+WifiMacQueueItem::operator delete (void *p, std::size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  ItemPool &pool = GetItemPool ();
+  NS_ASSERT (pool.nLive > 0);
+  pool.nLive--;
+  if (size != sizeof (WifiMacQueueItem) || !pool.enabled)
+    {
+      ::operator delete (p);
+      return;
+    }
+  pool.freeList.push_back (p);
+  if (pool.releasePending && pool.nLive == 0)
+    {
+      FreeItemSlabs ();
+    }
+}
+
+void
+WifiMacQueueItem::SetPoolEnabled (bool enabled)
+{
+  ItemPool &pool = GetItemPool ();
+  NS_ABORT_MSG_IF (pool.nLive != 0, "The item pool can only be switched when no item exists");
+  pool.enabled = enabled;
+}
+
+uint64_t
+WifiMacQueueItem::GetNAllocations (void)
+{
+  return g_nItemAllocations;
+}
+
+uint64_t
+WifiMacQueueItem::GetNHeapAllocations (void)
+{
+  return g_nItemHeapAllocations;
+}
+
 
 NS_OBJECT_TEMPLATE_CLASS_DEFINE (Queue,WifiMacQueueItem);
 
@@ -111,7 +267,9 @@ WifiMacQueue::GetTypeId (void)
 
 template<>
 WifiMacQueue::WifiQueue ()
-  : NS_LOG_TEMPLATE_DEFINE ("WifiMacQueue")
+  : m_expiryChecked (false),
+    m_nDropped (0),
+    NS_LOG_TEMPLATE_DEFINE ("WifiMacQueue")
 {
 }
 
@@ -140,20 +298,48 @@ WifiMacQueue::GetMaxDelay (void) const
 }
 
 template<>
-bool
-WifiMacQueue::TtlExceeded (ConstIterator &it)
+uint32_t
+WifiMacQueue::GetNDropped (void) const
 {
+  return m_nDropped;
+}
+
+
+template<>
+void
+WifiMacQueue::ExpireStale (void)
+{
+  // items are only dropped when Now - m_maxDelay moves forward, except for
+  // items pushed to the front, which may have been queued long ago
+  Time threshold = Simulator::Now () - m_maxDelay;
+  if (m_expiryChecked && threshold == m_expiryThreshold)
+    {
+      return;
+    }
   NS_LOG_FUNCTION (this);
+  m_expiryChecked = true;
+  m_expiryThreshold = threshold;
 
-  if (Simulator::Now () > (*it)->GetTimeStamp () + m_maxDelay)
+  while (!m_pushedFront.empty () && m_pushedFront.begin ()->first < threshold)
+    {
+      NS_LOG_DEBUG ("Removing packet that stayed in the queue for too long (" <<
+                    Simulator::Now () - m_pushedFront.begin ()->first << ")");
+      DoRemoveItem (m_pushedFront.begin ()->second);
+      m_nDropped++;
+    }
+
+  // the items pushed to the front are always ahead of the ones enqueued at
+  // the tail, whose timestamps are in increasing order
+  ConstIterator it = Head ();
+  std::advance (it, m_pushedFront.size ());
+  while (it != Tail () && (*it)->GetTimeStamp () < threshold)
     {
       NS_LOG_DEBUG ("Removing packet that stayed in the queue for too long (" <<
                     Simulator::Now () - (*it)->GetTimeStamp () << ")");
       auto curr = it++;
-      DoRemove (curr);
-      return true;
+      DoRemoveItem (curr);
+      m_nDropped++;
     }
-  return false;
 }
 
 template<>
@@ -170,20 +356,16 @@ WifiMacQueue::Enqueue (Ptr<WifiMacQueueItem> item)
   /* Hack: Disabling the maxpacket element, I do not want TFResp to be dropped
   if (QueueBase::GetNPackets () == GetMaxPackets ())
     {
-      auto it = Head ();
-      while (it != Tail () && !TtlExceeded (it))
-        {
-          it++;
-        }
+      ExpireStale ();
     }
 
   if (QueueBase::GetNPackets () == GetMaxPackets () && m_dropPolicy == DROP_OLDEST)
     {
       NS_LOG_DEBUG ("Remove the oldest item in the queue");
-      DoRemove (Head ());
+      DoRemoveItem (Head ());
     }
   */
-  return DoEnqueue (Tail (), item);
+  return DoEnqueueItem (false, item);
 }
 
 template<>
@@ -194,24 +376,126 @@ WifiMacQueue::PushFront (Ptr<WifiMacQueueItem> item)
 
   NS_ASSERT_MSG (GetMode () == QueueBase::QUEUE_MODE_PACKETS, "WifiMacQueues must be in packet mode");
 
-  // if the queue is full, remove the first stale packet (if any) encountered
-  // starting from the head of the queue, in order to make room for the new packet.
+  // if the queue is full, remove the stale packets (if any) in order to make
+  // room for the new packet.
   if (QueueBase::GetNPackets () == GetMaxPackets ())
     {
-      auto it = Head ();
-      while (it != Tail () && !TtlExceeded (it))
-        {
-          it++;
-        }
+      ExpireStale ();
     }
 
   if (QueueBase::GetNPackets () == GetMaxPackets () && m_dropPolicy == DROP_OLDEST)
     {
       NS_LOG_DEBUG ("Remove the oldest item in the queue");
-      DoRemove (Head ());
+      DoRemoveItem (Head ());
+      m_nDropped++;
+    }
+
+  return DoEnqueueItem (true, item);
+}
+
+template<>
+bool
+WifiMacQueue::DoEnqueueItem (bool front, Ptr<WifiMacQueueItem> item)
+{
+  if (!DoEnqueue (front ? Head () : Tail (), item))
+    {
+      m_nDropped++;
+      return false;
+    }
+  ConstIterator pos = front ? Head () : --Tail ();
+  const WifiMacHeader &hdr = item->GetHeader ();
+  FlowItems &addressFlow = m_addressFlows[hdr.GetAddr1 ()];
+  front ? addressFlow.push_front (pos) : addressFlow.push_back (pos);
+  if (hdr.IsQosData ())
+    {
+      FlowItems &qosFlow = m_qosFlows[std::make_pair (hdr.GetQosTid (), hdr.GetAddr1 ())];
+      front ? qosFlow.push_front (pos) : qosFlow.push_back (pos);
+    }
+  if (front)
+    {
+      m_pushedFront.insert (std::make_pair (item->GetTimeStamp (), pos));
+      m_expiryChecked = false;
     }
+  return true;
+}
+
+template<>
+void
+WifiMacQueue::RemoveFromFlows (ConstIterator pos)
+{
+  // the item is almost always at the head of its flows, hence the search
+  // from the front is usually O(1)
+  const WifiMacHeader &hdr = (*pos)->GetHeader ();
+  FlowItems &addressFlow = m_addressFlows[hdr.GetAddr1 ()];
+  FlowItems::iterator it = std::find (addressFlow.begin (), addressFlow.end (), pos);
+  NS_ASSERT (it != addressFlow.end ());
+  addressFlow.erase (it);
+  if (hdr.IsQosData ())
+    {
+      FlowItems &qosFlow = m_qosFlows[std::make_pair (hdr.GetQosTid (), hdr.GetAddr1 ())];
+      it = std::find (qosFlow.begin (), qosFlow.end (), pos);
+      NS_ASSERT (it != qosFlow.end ());
+      qosFlow.erase (it);
+    }
+  if (!m_pushedFront.empty ())
+    {
+      auto range = m_pushedFront.equal_range ((*pos)->GetTimeStamp ());
+      for (auto i = range.first; i != range.second; i++)
+        {
+          if (i->second == pos)
+            {
+              m_pushedFront.erase (i);
+              break;
+            }
+        }
+    }
+}
+
+template<>
+Ptr<WifiMacQueueItem>
+WifiMacQueue::DoDequeueItem (ConstIterator pos)
+{
+  RemoveFromFlows (pos);
+  return DoDequeue (pos);
+}
+
+template<>
+Ptr<WifiMacQueueItem>
+WifiMacQueue::DoRemoveItem (ConstIterator pos)
+{
+  RemoveFromFlows (pos);
+  return DoRemove (pos);
+}
+
+template<>
+WifiMacQueue::FlowItems *
+WifiMacQueue::FindQosFlow (uint8_t tid, Mac48Address addr)
+{
+  // flows are never erased, so that the returned pointer stays valid
+  // while items are removed from the queue
+  QosFlows::iterator it = m_qosFlows.find (std::make_pair (tid, addr));
+  return it != m_qosFlows.end () ? &it->second : 0;
+}
 
-  return DoEnqueue (Head (), item);
+template<>
+WifiMacQueue::FlowItems *
+WifiMacQueue::FindAddressFlow (Mac48Address addr)
+{
+  AddressFlows::iterator it = m_addressFlows.find (addr);
+  return it != m_addressFlows.end () ? &it->second : 0;
+}
+
+template<>
+bool
+WifiMacQueue::GetFlowHead (FlowItems *flow, ConstIterator &it)
+{
+  ExpireStale ();
+  if (flow != 0 && !flow->empty ())
+    {
+      it = flow->front ();
+      return true;
+    }
+  return false;
 }
 
 template<>
@@ -220,12 +504,10 @@ WifiMacQueue::Dequeue (void)
 {
   NS_LOG_FUNCTION (this);
 
-  for (auto it = Head (); it != Tail (); )
+  ExpireStale ();
+  if (Head () != Tail ())
     {
-      if (!TtlExceeded (it))
-        {
-          return DoDequeue (it);
-        }
+      return DoDequeueItem (Head ());
     }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
@@ -238,17 +520,53 @@ WifiMacQueue::DequeueByTidAndAddress (uint8_t tid,
 {
   NS_LOG_FUNCTION (this << dest);
 
-  for (auto it = Head (); it != Tail (); )
+  if (type == WifiMacHeader::ADDR1)
     {
-      if (!TtlExceeded (it))
+      ConstIterator it;
+      if (GetFlowHead (FindQosFlow (tid, dest), it))
         {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetAddress (type) == dest &&
-              (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              return DoDequeue (it);
-            }
+          return DoDequeueItem (it);
+        }
+      NS_LOG_DEBUG ("The queue is empty");
+      return 0;
+    }
 
-          it++;
+  ExpireStale ();
+  for (auto it = Head (); it != Tail (); it++)
+    {
+      if ((*it)->GetHeader ().IsQosData () && (*it)->GetAddress (type) == dest &&
+          (*it)->GetHeader ().GetQosTid () == tid)
+        {
+          return DoDequeueItem (it);
+        }
+    }
+  NS_LOG_DEBUG ("The queue is empty");
+  return 0;
+}
+
+template<>
+Ptr<WifiMacQueueItem>
+WifiMacQueue::DequeueByAddress (WifiMacHeader::AddressType type, Mac48Address dest)
+{
+  NS_LOG_FUNCTION (this << dest);
+
+  if (type == WifiMacHeader::ADDR1)
+    {
+      ConstIterator it;
+      if (GetFlowHead (FindAddressFlow (dest), it))
+        {
+          return DoDequeueItem (it);
+        }
+      NS_LOG_DEBUG ("The queue is empty");
+      return 0;
+    }
+
+  ExpireStale ();
+  for (auto it = Head (); it != Tail (); it++)
+    {
+      if ((*it)->GetAddress (type) == dest)
+        {
+          return DoDequeueItem (it);
         }
     }
   NS_LOG_DEBUG ("The queue is empty");
@@ -261,17 +579,13 @@ WifiMacQueue::DequeueFirstAvailable (const Ptr<QosBlockedDestinations> blockedPa
 {
   NS_LOG_FUNCTION (this);
 
-  for (auto it = Head (); it != Tail (); )
+  ExpireStale ();
+  for (auto it = Head (); it != Tail (); it++)
     {
-      if (!TtlExceeded (it))
+      if (!(*it)->GetHeader ().IsQosData ()
+          || !blockedPackets->IsBlocked ((*it)->GetHeader ().GetAddr1 (), (*it)->GetHeader ().GetQosTid ()))
         {
-          if (!(*it)->GetHeader ().IsQosData ()
-              || !blockedPackets->IsBlocked ((*it)->GetHeader ().GetAddr1 (), (*it)->GetHeader ().GetQosTid ()))
-            {
-              return DoDequeue (it);
-            }
-
-          it++;
+          return DoDequeueItem (it);
         }
     }
   NS_LOG_DEBUG ("The queue is empty");
@@ -304,17 +618,53 @@ WifiMacQueue::PeekByTidAndAddress (uint8_t tid,
 {
   NS_LOG_FUNCTION (this << dest);
 
-  for (auto it = Head (); it != Tail (); )
+  if (type == WifiMacHeader::ADDR1)
     {
-      if (!TtlExceeded (it))
+      ConstIterator it;
+      if (GetFlowHead (FindQosFlow (tid, dest), it))
         {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetAddress (type) == dest &&
-              (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              return DoPeek (it);
-            }
+          return DoPeek (it);
+        }
+      NS_LOG_DEBUG ("The queue is empty");
+      return 0;
+    }
 
-          it++;
+  ExpireStale ();
+  for (auto it = Head (); it != Tail (); it++)
+    {
+      if ((*it)->GetHeader ().IsQosData () && (*it)->GetAddress (type) == dest &&
+          (*it)->GetHeader ().GetQosTid () == tid)
+        {
+          return DoPeek (it);
+        }
+    }
+  NS_LOG_DEBUG ("The queue is empty");
+  return 0;
+}
+
+template<>
+Ptr<const WifiMacQueueItem>
+WifiMacQueue::PeekByAddress (WifiMacHeader::AddressType type, Mac48Address dest)
+{
+  NS_LOG_FUNCTION (this << dest);
+
+  if (type == WifiMacHeader::ADDR1)
+    {
+      ConstIterator it;
+      if (GetFlowHead (FindAddressFlow (dest), it))
+        {
+          return DoPeek (it);
+        }
+      NS_LOG_DEBUG ("The queue is empty");
+      return 0;
+    }
+
+  ExpireStale ();
+  for (auto it = Head (); it != Tail (); it++)
+    {
+      if ((*it)->GetAddress (type) == dest)
+        {
+          return DoPeek (it);
         }
     }
   NS_LOG_DEBUG ("The queue is empty");
@@ -327,17 +677,13 @@ WifiMacQueue::PeekFirstAvailable (const Ptr<QosBlockedDestinations> blockedPacke
 {
   NS_LOG_FUNCTION (this);
 
-  for (auto it = Head (); it != Tail (); )
+  ExpireStale ();
+  for (auto it = Head (); it != Tail (); it++)
     {
-      if (!TtlExceeded (it))
+      if (!(*it)->GetHeader ().IsQosData ()
+          || !blockedPackets->IsBlocked ((*it)->GetHeader ().GetAddr1 (), (*it)->GetHeader ().GetQosTid ()))
         {
-          if (!(*it)->GetHeader ().IsQosData ()
-              || !blockedPackets->IsBlocked ((*it)->GetHeader ().GetAddr1 (), (*it)->GetHeader ().GetQosTid ()))
-            {
-              return DoPeek (it);
-            }
-
-          it++;
+          return DoPeek (it);
         }
     }
   NS_LOG_DEBUG ("The queue is empty");
@@ -350,12 +696,10 @@ WifiMacQueue::Remove (void)
 {
   NS_LOG_FUNCTION (this);
 
-  for (auto it = Head (); it != Tail (); )
+  ExpireStale ();
+  if (Head () != Tail ())
     {
-      if (!TtlExceeded (it))
-        {
-          return DoRemove (it);
-        }
+      return DoRemoveItem (Head ());
     }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
@@ -374,17 +718,13 @@ WifiMacQueue::Remove (Ptr<const Packet> packet)
 {
   NS_LOG_FUNCTION (this << packet);
 
-  for (auto it = Head (); it != Tail (); )
+  ExpireStale ();
+  for (auto it = Head (); it != Tail (); it++)
     {
-      if (!TtlExceeded (it))
+      if ((*it)->GetPacket () == packet)
         {
-          if ((*it)->GetPacket () == packet)
-            {
-              DoRemove (it);
-              return true;
-            }
-
-          it++;
+          DoRemoveItem (it);
+          return true;
         }
     }
   NS_LOG_DEBUG ("Packet " << packet << " not found in the queue");
@@ -400,17 +740,25 @@ WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, WifiMacHeader::AddressTyp
 
   uint32_t nPackets = 0;
 
-  for (auto it = Head (); it != Tail (); )
+  if (type == WifiMacHeader::ADDR1)
     {
-      if (!TtlExceeded (it))
+      FlowItems *flow = FindQosFlow (tid, addr);
+      ConstIterator it;
+      if (GetFlowHead (flow, it))
         {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetAddress (type) == addr &&
-              (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              nPackets++;
-            }
+          nPackets = flow->size ();
+        }
+      NS_LOG_DEBUG ("returns " << nPackets);
+      return nPackets;
+    }
 
-          it++;
+  ExpireStale ();
+  for (auto it = Head (); it != Tail (); it++)
+    {
+      if ((*it)->GetHeader ().IsQosData () && (*it)->GetAddress (type) == addr &&
+          (*it)->GetHeader ().GetQosTid () == tid)
+        {
+          nPackets++;
         }
     }
   NS_LOG_DEBUG ("returns " << nPackets);
@@ -423,16 +771,10 @@ WifiMacQueue::IsEmpty (void)
 {
   NS_LOG_FUNCTION (this);
 
-  for (auto it = Head (); it != Tail (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          NS_LOG_DEBUG ("returns false");
-          return false;
-        }
-    }
-  NS_LOG_DEBUG ("returns true");
-  return true;
+  ExpireStale ();
+  bool empty = (Head () == Tail ());
+  NS_LOG_DEBUG ("returns " << empty);
+  return empty;
 }
 
 template<>
@@ -442,13 +784,7 @@ WifiMacQueue::GetNPackets (void)
   NS_LOG_FUNCTION (this);
 
   // remove packets that stayed in the queue for too long
-  for (auto it = Head (); it != Tail (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          it++;
-        }
-    }
+  ExpireStale ();
   return QueueBase::GetNPackets ();
 }
 
@@ -459,13 +795,7 @@ WifiMacQueue::GetNBytes (void)
   NS_LOG_FUNCTION (this);
 
   // remove packets that stayed in the queue for too long
-  for (auto it = Head (); it != Tail (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          it++;
-        }
-    }
+  ExpireStale ();
   return QueueBase::GetNBytes ();
 }
 
@@ -26,6 +26,8 @@
 
 #include "ns3/queue.h"
 #include "wifi-mac-header.h"
+#include <list>
+#include <map>
 
 namespace ns3 {
 class QosBlockedDestinations;
@@ -45,6 +47,14 @@ public:
    * \param header the Wifi Mac header included in the created item.
    */
   WifiMacQueueItem (Ptr<const Packet> p, const WifiMacHeader & header);
+  /**
+   * \brief Create a Wifi MAC queue item for a frame put back in a queue,
+   * keeping the time when the frame was first enqueued.
+   * \param p the const packet included in the created item.
+   * \param header the Wifi Mac header included in the created item.
+   * \param tstamp the time when the frame was first enqueued.
+   */
+  WifiMacQueueItem (Ptr<const Packet> p, const WifiMacHeader & header, Time tstamp);
 
   virtual ~WifiMacQueueItem ();
 
@@ -80,6 +90,42 @@ public:
    */
   uint32_t GetSize (void) const;
 
+  /**
+   * One item is created for every frame handed to the MAC, so items are
+   * recycled through a free list refilled a slab at a time. The slabs are
+   * freed at Simulator::Destroy or, if some items are still referenced
+   * then, as soon as the last of them is deleted.
+   *
+   * \param size the size of the item
+   * \return the allocated memory
+   */
+  static void* operator new (std::size_t size);
+  /**
+   * Return an item to the free list.
+   *
+   * \param p the item memory
+   * \param size the size of the item
+   */
+  static void operator delete (void *p, std::size_t size);
+  /**
+   * Take new items from the item pool (the default) or from the global
+   * heap. Can only be called when no item exists, e.g., before the
+   * simulation is set up.
+   *
+   * \param enabled whether new items are taken from the pool
+   */
+  static void SetPoolEnabled (bool enabled);
+  /**
+   * \return the number of items created since the start of the program
+   */
+  static uint64_t GetNAllocations (void);
+  /**
+   * \return the number of allocations from the global heap made to create
+   *         the items, i.e., the number of slabs, plus the number of items
+   *         created while the pool was disabled
+   */
+  static uint64_t GetNHeapAllocations (void);
+
 private:
   /**
    * \brief Default constructor
@@ -176,6 +222,14 @@ public:
    * \return the maximum delay
    */
   Time GetMaxDelay (void) const;
+  /**
+   * Return the number of items dropped because they stayed in the queue for
+   * too long or because the queue was full. Unlike the Drop trace source,
+   * this does not count the items taken out with Remove.
+   *
+   * \return the number of items dropped
+   */
+  uint32_t GetNDropped (void) const;
 
   /**
    * Enqueue the given Wifi MAC queue item at the <i>end</i> of the queue.
@@ -213,6 +267,18 @@ public:
   Ptr<Item> DequeueByTidAndAddress (uint8_t tid,
                                                 WifiMacHeader::AddressType type,
                                                 Mac48Address addr);
+  /**
+   * Search and return, if present in the queue, the first packet having the
+   * address indicated by <i>type</i> equal to <i>addr</i>, regardless of its
+   * TID. This method removes the packet from the queue. It is used by the
+   * per-RU transmitters to pull their packets out of the shared SU queue.
+   *
+   * \param type the given address type
+   * \param addr the given destination
+   *
+   * \return the packet
+   */
+  Ptr<Item> DequeueByAddress (WifiMacHeader::AddressType type, Mac48Address addr);
   /**
    * Return first available packet for transmission. A packet could be no available
    * if it is a QoS packet with a tid and an address1 fields equal to <i>tid</i> and <i>addr</i>
@@ -247,6 +313,18 @@ public:
   Ptr<const Item> PeekByTidAndAddress (uint8_t tid,
                                                    WifiMacHeader::AddressType type,
                                                    Mac48Address addr);
+  /**
+   * Search and return, if present in the queue, the first packet having the
+   * address indicated by <i>type</i> equal to <i>addr</i>, regardless of its
+   * TID. This method does not remove the packet from the queue.
+   *
+   * \param type the given address type
+   * \param addr the given destination
+   *
+   * \return packet
+   */
+  Ptr<const Item> PeekByAddress (WifiMacHeader::AddressType type,
+                                 Mac48Address addr);
   /**
    * Return first available packet for transmission. The packet is not removed from queue.
    *
@@ -309,17 +387,81 @@ public:
 
 private:
   /**
-   * Remove the item pointed to by the iterator <i>it</i> if it has been in the
-   * queue for too long. If the item is removed, the iterator is updated to
-   * point to the item that followed the erased one.
+   * Remove all the items that have been in the queue for too long. Items
+   * enqueued at the tail are in timestamp order, so they are trimmed from
+   * the head; items pushed to the front are tracked by m_pushedFront. The
+   * work is skipped if nothing can have expired since the last call.
+   */
+  void ExpireStale (void);
+
+  /// The positions in the queue of the items of a flow, in queue order
+  typedef std::list<typename Queue<Item>::ConstIterator> FlowItems;
+  /// QoS data flows, indexed by (TID, Address 1)
+  typedef std::map<std::pair<uint8_t, Mac48Address>, FlowItems> QosFlows;
+  /// Flows indexed by Address 1, regardless of the TID
+  typedef std::map<Mac48Address, FlowItems> AddressFlows;
+
+  /**
+   * Enqueue the given item at the head or at the tail of the queue and
+   * link it to its flows.
+   *
+   * \param front true to enqueue at the head, false to enqueue at the tail
+   * \param item the item to enqueue
+   * \return true if success, false if the packet has been dropped
+   */
+  bool DoEnqueueItem (bool front, Ptr<Item> item);
+  /**
+   * Unlink the item pointed to by <i>pos</i> from its flows and dequeue it.
    *
-   * \param it an iterator pointing to the item
-   * \return true if the item is removed, false otherwise
+   * \param pos an iterator pointing to the item
+   * \return the item
    */
-  bool TtlExceeded (typename Queue<Item>::ConstIterator &it);
+  Ptr<Item> DoDequeueItem (typename Queue<Item>::ConstIterator pos);
+  /**
+   * Unlink the item pointed to by <i>pos</i> from its flows and remove
+   * (drop) it.
+   *
+   * \param pos an iterator pointing to the item
+   * \return the item
+   */
+  Ptr<Item> DoRemoveItem (typename Queue<Item>::ConstIterator pos);
+  /**
+   * Unlink the item pointed to by <i>pos</i> from its flows.
+   *
+   * \param pos an iterator pointing to the item
+   */
+  void RemoveFromFlows (typename Queue<Item>::ConstIterator pos);
+  /**
+   * Drop the items that stayed in the queue for too long and return the
+   * first remaining item of the given flow.
+   *
+   * \param flow the flow (possibly null)
+   * \param it set to the position of the head of the flow, if any
+   * \return true if the flow is not empty, false otherwise
+   */
+  bool GetFlowHead (FlowItems *flow, typename Queue<Item>::ConstIterator &it);
+  /**
+   * \param tid the TID
+   * \param addr the Address 1
+   * \return the QoS data flow for (tid, addr), or null if never seen
+   */
+  FlowItems * FindQosFlow (uint8_t tid, Mac48Address addr);
+  /**
+   * \param addr the Address 1
+   * \return the flow for addr, or null if never seen
+   */
+  FlowItems * FindAddressFlow (Mac48Address addr);
+
+  QosFlows m_qosFlows;                      //!< Per-(TID, Address 1) FIFOs of QoS data
+  AddressFlows m_addressFlows;              //!< Per-Address 1 FIFOs of all the items
 
   Time m_maxDelay;                          //!< Time to live for packets in the queue
   DropPolicy m_dropPolicy;                  //!< Drop behavior of queue
+  /// Items pushed to the front, indexed by their timestamp
+  std::multimap<Time, typename Queue<Item>::ConstIterator> m_pushedFront;
+  bool m_expiryChecked;                     //!< Whether m_expiryThreshold is valid
+  Time m_expiryThreshold;                   //!< Timestamp before which items had expired at the last check
+  uint32_t m_nDropped;                      //!< Items expired or dropped at enqueue
 
   NS_LOG_TEMPLATE_DECLARE;                  //!< redefinition of the log component
 };
@@ -78,6 +78,7 @@ WifiNetDevice::WifiNetDevice ()
       m_phyMu[i]=0;
       m_stationManagerMu[i]=0;
     }
+  m_counters = Create<WifiDeviceCounters> ();
 }
 
 WifiNetDevice::~WifiNetDevice ()
@@ -127,6 +128,11 @@ WifiNetDevice::CompleteConfig (void)
   m_mac->SetLinkDownCallback (MakeCallback (&WifiNetDevice::LinkDown, this));
   m_stationManager->SetupPhy (m_phy);
   m_stationManager->SetupMac (m_mac);
+  Ptr<RegularWifiMac> rmac = DynamicCast<RegularWifiMac> (m_mac);
+  if (rmac != 0)
+    {
+      rmac->SetCounters (m_counters);
+    }
   m_configComplete = true;
 }
 
@@ -275,6 +281,25 @@ WifiNetDevice::GetPhy (void) const
   return m_phy;
 }
 
+Ptr<WifiPhy>
+WifiNetDevice::GetMuPhy (uint32_t i) const
+{
+  NS_ASSERT (i < 9);
+  return m_phyMu[i];
+}
+
+WifiDeviceCounters
+WifiNetDevice::GetCounters (void) const
+{
+  WifiDeviceCounters counters = *m_counters;
+  Ptr<RegularWifiMac> rmac = DynamicCast<RegularWifiMac> (m_mac);
+  if (rmac != 0)
+    {
+      counters.queueDrops = rmac->GetNQueueDrops ();
+    }
+  return counters;
+}
+
 Ptr<WifiRemoteStationManager>
 WifiNetDevice::GetRemoteStationManager (void) const
 {
@@ -24,6 +24,7 @@
 #include "ns3/net-device.h"
 #include "ns3/queue-item.h"
 #include "ns3/traced-callback.h"
+#include "wifi-device-counters.h"
 
 namespace ns3 {
 
@@ -82,6 +83,15 @@ public:
    * \returns the phy we are currently using.
    */
   Ptr<WifiPhy> GetPhy (void) const;
+  /**
+   * \param i the index of the RU
+   * \returns the MU phy of RU <i>i</i>, or 0 if there is none.
+   */
+  Ptr<WifiPhy> GetMuPhy (uint32_t i) const; //infocom
+  /**
+   * \returns a snapshot of the MAC counters of this device
+   */
+  WifiDeviceCounters GetCounters (void) const; //infocom
   /**
    * \returns the remote station manager we are currently using.
    */
@@ -228,6 +238,7 @@ private:
   Ptr<WifiRemoteStationManager> m_stationManager; //!< the station manager
   Ptr<WifiRemoteStationManager> m_stationManagerMu[9]; //!< the station manager
   Ptr<NetDeviceQueueInterface> m_queueInterface;   //!< NetDevice queue interface
+  Ptr<WifiDeviceCounters> m_counters; //!< MAC counters, updated by the MAC
   NetDevice::ReceiveCallback m_forwardUp; //!< forward up callback
   NetDevice::PromiscReceiveCallback m_promiscRx; //!< promiscious receive callback
 
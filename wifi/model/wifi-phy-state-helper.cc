@@ -67,9 +67,15 @@ WifiPhyStateHelper::WifiPhyStateHelper ()
     m_startCcaBusy (Seconds (0)),
     m_startSwitching (Seconds (0)),
     m_startSleep (Seconds (0)),
-    m_previousStateChangeTime (Seconds (0))
+    m_previousStateChangeTime (Seconds (0)),
+    m_loggedEnd (Seconds (0)),
+    m_loggedState (WifiPhy::IDLE)
 {
   NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i <= WifiPhy::SLEEP; i++)
+    {
+      m_stateTime[i] = Seconds (0);
+    }
 }
 
 void
@@ -189,6 +195,62 @@ WifiPhyStateHelper::GetLastRxStartTime (void) const
   return m_startRx;
 }
 
+Time
+WifiPhyStateHelper::GetCumulativeStateTime (WifiPhy::State state) const
+{
+  Time now = Simulator::Now ();
+  Time total = m_stateTime[state];
+  if (m_loggedEnd > now)
+    {
+      //TX and SWITCHING are logged up to their end when they start
+      if (state == m_loggedState)
+        {
+          total -= m_loggedEnd - now;
+        }
+      return total;
+    }
+  //Nothing is logged after m_loggedEnd yet: add the elapsed part of
+  //the current state
+  Time busyStart = now;
+  if (m_sleeping)
+    {
+      busyStart = Max (m_loggedEnd, m_startSleep);
+      if (state == WifiPhy::SLEEP)
+        {
+          total += now - busyStart;
+        }
+    }
+  else if (m_rxing)
+    {
+      busyStart = Max (m_loggedEnd, m_startRx);
+      if (state == WifiPhy::RX)
+        {
+          total += now - busyStart;
+        }
+    }
+  Time idle;
+  Time ccaBusy;
+  SplitIdleAndCcaBusy (m_loggedEnd, busyStart, &idle, &ccaBusy);
+  if (state == WifiPhy::IDLE)
+    {
+      total += idle;
+    }
+  else if (state == WifiPhy::CCA_BUSY)
+    {
+      total += ccaBusy;
+    }
+  return total;
+}
+
+void
+WifiPhyStateHelper::SplitIdleAndCcaBusy (Time start, Time end, Time *idle, Time *ccaBusy) const
+{
+  Time ccaStart = Min (end, Max (start, m_startCcaBusy));
+  Time ccaEnd = Min (end, Max (ccaStart, m_endCcaBusy));
+  *ccaBusy = ccaEnd - ccaStart;
+  *idle = (end - start) - *ccaBusy;
+}
+
 WifiPhy::State
 WifiPhyStateHelper::GetState (void) const
 {
@@ -314,9 +376,33 @@ WifiPhyStateHelper::LogPreviousIdleAndCcaBusyStates (void)
       Time ccaBusyStart = Max (m_endTx, m_endRx);
       ccaBusyStart = Max (ccaBusyStart, m_startCcaBusy);
       ccaBusyStart = Max (ccaBusyStart, m_endSwitching);
-      m_stateLogger (ccaBusyStart, idleStart - ccaBusyStart, WifiPhy::CCA_BUSY);
+      LogState (ccaBusyStart, idleStart - ccaBusyStart, WifiPhy::CCA_BUSY);
+    }
+  LogState (idleStart, now - idleStart, WifiPhy::IDLE);
+}
+
+void
+WifiPhyStateHelper::LogState (Time start, Time duration, WifiPhy::State state)
+{
+  m_stateLogger (start, duration, state);
+  Time end = start + duration;
+  if (end <= m_loggedEnd)
+    {
+      return;
+    }
+  if (start > m_loggedEnd)
+    {
+      //Gaps between the reported intervals are IDLE periods: count them
+      //so that the totals cover the whole time line
+      m_stateTime[WifiPhy::IDLE] += start - m_loggedEnd;
+    }
+  else
+    {
+      start = m_loggedEnd;
     }
-  m_stateLogger (idleStart, now - idleStart, WifiPhy::IDLE);
+  m_stateTime[state] += end - start;
+  m_loggedEnd = end;
+  m_loggedState = state;
 }
 
 void
@@ -333,7 +419,7 @@ WifiPhyStateHelper::SwitchToTx (Time txDuration, Ptr<const Packet> packet, doubl
        * as its endRx event are cancelled by the caller.
        */
       m_rxing = false;
-      m_stateLogger (m_startRx, now - m_startRx, WifiPhy::RX);
+      LogState (m_startRx, now - m_startRx, WifiPhy::RX);
       m_endRx = now;
       break;
     case WifiPhy::CCA_BUSY:
@@ -341,7 +427,7 @@ WifiPhyStateHelper::SwitchToTx (Time txDuration, Ptr<const Packet> packet, doubl
         Time ccaStart = Max (m_endRx, m_endTx);
         ccaStart = Max (ccaStart, m_startCcaBusy);
         ccaStart = Max (ccaStart, m_endSwitching);
-        m_stateLogger (ccaStart, now - ccaStart, WifiPhy::CCA_BUSY);
+        LogState (ccaStart, now - ccaStart, WifiPhy::CCA_BUSY);
       } break;
     case WifiPhy::IDLE:
       LogPreviousIdleAndCcaBusyStates ();
@@ -352,7 +438,7 @@ WifiPhyStateHelper::SwitchToTx (Time txDuration, Ptr<const Packet> packet, doubl
       NS_FATAL_ERROR ("Invalid WifiPhy state.");
       break;
     }
-  m_stateLogger (now, txDuration, WifiPhy::TX);
+  LogState (now, txDuration, WifiPhy::TX);
   m_previousStateChangeTime = now;
   m_endTx = now + txDuration;
   m_startTx = now;
@@ -376,7 +462,7 @@ WifiPhyStateHelper::SwitchToRx (Time rxDuration)
         Time ccaStart = Max (m_endRx, m_endTx);
         ccaStart = Max (ccaStart, m_startCcaBusy);
         ccaStart = Max (ccaStart, m_endSwitching);
-        m_stateLogger (ccaStart, now - ccaStart, WifiPhy::CCA_BUSY);
+        LogState (ccaStart, now - ccaStart, WifiPhy::CCA_BUSY);
       } break;
     case WifiPhy::SWITCHING:
     case WifiPhy::RX:
@@ -405,7 +491,7 @@ WifiPhyStateHelper::SwitchToChannelSwitching (Time switchingDuration)
        * as its endRx event are cancelled by the caller.
        */
       m_rxing = false;
-      m_stateLogger (m_startRx, now - m_startRx, WifiPhy::RX);
+      LogState (m_startRx, now - m_startRx, WifiPhy::RX);
       m_endRx = now;
       break;
     case WifiPhy::CCA_BUSY:
@@ -413,7 +499,7 @@ WifiPhyStateHelper::SwitchToChannelSwitching (Time switchingDuration)
         Time ccaStart = Max (m_endRx, m_endTx);
         ccaStart = Max (ccaStart, m_startCcaBusy);
         ccaStart = Max (ccaStart, m_endSwitching);
-        m_stateLogger (ccaStart, now - ccaStart, WifiPhy::CCA_BUSY);
+        LogState (ccaStart, now - ccaStart, WifiPhy::CCA_BUSY);
       } break;
     case WifiPhy::IDLE:
       LogPreviousIdleAndCcaBusyStates ();
@@ -431,7 +517,7 @@ WifiPhyStateHelper::SwitchToChannelSwitching (Time switchingDuration)
       m_endCcaBusy = now;
     }
 
-  m_stateLogger (now, switchingDuration, WifiPhy::SWITCHING);
+  LogState (now, switchingDuration, WifiPhy::SWITCHING);
   m_previousStateChangeTime = now;
   m_startSwitching = now;
   m_endSwitching = now + switchingDuration;
@@ -474,7 +560,7 @@ WifiPhyStateHelper::DoSwitchFromRx (void)
   NS_ASSERT (m_rxing);
 
   Time now = Simulator::Now ();
-  m_stateLogger (m_startRx, now - m_startRx, WifiPhy::RX);
+  LogState (m_startRx, now - m_startRx, WifiPhy::RX);
   m_previousStateChangeTime = now;
   m_rxing = false;
 
@@ -525,7 +611,7 @@ WifiPhyStateHelper::SwitchToSleep (void)
         Time ccaStart = Max (m_endRx, m_endTx);
         ccaStart = Max (ccaStart, m_startCcaBusy);
         ccaStart = Max (ccaStart, m_endSwitching);
-        m_stateLogger (ccaStart, now - ccaStart, WifiPhy::CCA_BUSY);
+        LogState (ccaStart, now - ccaStart, WifiPhy::CCA_BUSY);
       } break;
     case WifiPhy::RX:
     case WifiPhy::SWITCHING:
@@ -547,7 +633,7 @@ WifiPhyStateHelper::SwitchFromSleep (Time duration)
   NS_LOG_FUNCTION (this << duration);
   NS_ASSERT (IsStateSleep ());
   Time now = Simulator::Now ();
-  m_stateLogger (m_startSleep, now - m_startSleep, WifiPhy::SLEEP);
+  LogState (m_startSleep, now - m_startSleep, WifiPhy::SLEEP);
   m_previousStateChangeTime = now;
   m_sleeping = false;
   NotifyWakeup ();
@@ -132,6 +132,17 @@ public:
    * \return the time the last RX start.
    */
   Time GetLastRxStartTime (void) const;
+  /**
+   * Return the total time spent in the given state since the start of the
+   * simulation, including the elapsed part of the current state.
+   *
+   * The totals are integrated from the intervals reported by the State trace
+   * source, so querying them costs no event and no listener callback.
+   *
+   * \param state the state
+   * \return the total time spent in <i>state</i>
+   */
+  Time GetCumulativeStateTime (WifiPhy::State state) const;
 
   /**
    * Switch state to TX for the given duration.
@@ -244,6 +255,24 @@ private:
    * Log the ideal and CCA states.
    */
   void LogPreviousIdleAndCcaBusyStates (void);
+  /**
+   * Fire the State trace source and add the interval to the state totals.
+   *
+   * \param start the start of the interval
+   * \param duration the duration of the interval
+   * \param state the state of the PHY during the interval
+   */
+  void LogState (Time start, Time duration, WifiPhy::State state);
+  /**
+   * Split an unlogged interval without TX, RX, switching or sleep into its
+   * IDLE and CCA_BUSY parts.
+   *
+   * \param start the start of the interval
+   * \param end the end of the interval
+   * \param idle the IDLE part
+   * \param ccaBusy the CCA_BUSY part
+   */
+  void SplitIdleAndCcaBusy (Time start, Time end, Time *idle, Time *ccaBusy) const;
 
   /**
    * Notify all WifiPhyListener that the transmission has started for the given duration.
@@ -309,6 +338,9 @@ private:
   Time m_startSwitching; ///< start switching
   Time m_startSleep; ///< start sleep
   Time m_previousStateChangeTime; ///< previous state change time
+  Time m_stateTime[WifiPhy::SLEEP + 1]; ///< total logged time, per state
+  Time m_loggedEnd; ///< end of the last logged interval
+  WifiPhy::State m_loggedState; ///< state of the last logged interval
 
   Listeners m_listeners; ///< listeners
   TracedCallback<Ptr<const Packet>, double, WifiMode, WifiPreamble> m_rxOkTrace; ///< receive OK trace callback
@@ -31,6 +31,7 @@
 #include "ampdu-tag.h"
 #include "wifi-utils.h"
 #include "frame-capture-model.h"
+#include "ns3/hot-path-profiler.h"
 
 namespace ns3 {
 
@@ -189,6 +190,21 @@ WifiPhy::GetTypeId (void)
                    MakeDoubleAccessor (&WifiPhy::SetCcaMode1Threshold,
                                        &WifiPhy::GetCcaMode1Threshold),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("BssColor",
+                   "The BSS color carried by transmitted PPDUs. Received PPDUs with "
+                   "a different non-zero color are treated as inter-BSS interference. "
+                   "0 disables BSS color filtering.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&WifiPhy::SetBssColor,
+                                         &WifiPhy::GetBssColor),
+                   MakeUintegerChecker<uint8_t> (0, 63))
+    .AddAttribute ("ObssPdLevel",
+                   "Inter-BSS PPDUs received below this level (dBm) do not set "
+                   "CCA BUSY (spatial reuse); they only add interference.",
+                   DoubleValue (-82.0),
+                   MakeDoubleAccessor (&WifiPhy::SetObssPdLevel,
+                                       &WifiPhy::GetObssPdLevel),
+                   MakeDoubleChecker<double> ())
     .AddAttribute ("TxGain",
                    "Transmission gain (dB).",
                    DoubleValue (0.0),
@@ -530,6 +546,38 @@ WifiPhy::GetCcaMode1Threshold (void) const
   return WToDbm (m_ccaMode1ThresholdW);
 }
 
+void
+WifiPhy::SetBssColor (uint8_t color)
+{
+  NS_LOG_FUNCTION (this << (uint16_t)color);
+  m_bssColor = color;
+}
+
+uint8_t
+WifiPhy::GetBssColor (void) const
+{
+  return m_bssColor;
+}
+
+void
+WifiPhy::SetObssPdLevel (double level)
+{
+  NS_LOG_FUNCTION (this << level);
+  m_obssPdLevelW = DbmToW (level);
+}
+
+double
+WifiPhy::GetObssPdLevel (void) const
+{
+  return WToDbm (m_obssPdLevelW);
+}
+
+bool
+WifiPhy::IsInterBss (uint8_t color) const
+{
+  return m_bssColor != 0 && color != 0 && color != m_bssColor;
+}
+
 void
 WifiPhy::SetRxNoiseFigure (double noiseFigureDb)
 {
@@ -2282,6 +2330,7 @@ WifiPhy::CalculatePlcpPreambleAndHeaderDuration (WifiTxVector txVector)
 Time
 WifiPhy::CalculateTxDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, uint8_t incFlag)
 {
+  NS_PROFILE_FUNCTION ("WifiPhy::CalculateTxDuration");
   Time duration = CalculatePlcpPreambleAndHeaderDuration (txVector)
     + GetPayloadDuration (size, txVector, frequency, mpdutype, incFlag);
   return duration;
@@ -2371,6 +2420,7 @@ WifiPhy::SendPacket (Ptr<const Packet> packet, WifiTxVector txVector, MpduType m
 
   txVector.SetMuMode (GetMuMode ());
   txVector.SetRuBits (GetRuBits ()); // infocom: Set the MU mode so that TX duration can be calculated correctly
+  txVector.SetBssColor (GetBssColor ());
   // TODO Check the correct setting of TxDuration
   Time txDuration = CalculateTxDuration (packet->GetSize (), txVector, GetFrequency (), mpdutype, 1);
   NS_ASSERT (txDuration.IsStrictlyPositive ());
@@ -2405,6 +2455,7 @@ WifiPhy::SendPacket (Ptr<const Packet> packet, WifiTxVector txVector, MpduType m
 void
 WifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet, double rxPowerW, Time rxDuration)
 {
+  NS_PROFILE_FUNCTION ("WifiPhy::StartReceivePreambleAndHeader");
   //This function should be later split to check separately whether plcp preamble and plcp header can be successfully received.
   //Note: plcp preamble reception is not yet modeled.
   NS_LOG_FUNCTION (this << packet << WToDbm (rxPowerW) << rxDuration);
@@ -2564,6 +2615,7 @@ void
 WifiPhy::EndReceive (Ptr<Packet> packet, WifiPreamble preamble, MpduType mpdutype, Ptr<InterferenceHelper::Event> event)
 {
   NS_LOG_FUNCTION (this << packet << event);
+  NS_PROFILE_FUNCTION ("WifiPhy::EndReceive");
   NS_ASSERT (IsStateRx ());
   NS_ASSERT (event->GetEndTime () == Simulator::Now ());
 
@@ -3632,6 +3684,12 @@ WifiPhy::GetStateDuration (void)
   return m_state->GetStateDuration ();
 }
 
+Time
+WifiPhy::GetCumulativeStateTime (State state) const
+{
+  return m_state->GetCumulativeStateTime (state);
+}
+
 Time
 WifiPhy::GetDelayUntilIdle (void)
 {
@@ -341,6 +341,11 @@ public:
    * \return the amount of time since the current state has started.
    */
   Time GetStateDuration (void);
+  /**
+   * \param state the state
+   * \return the total time this PHY has spent in <i>state</i> so far.
+   */
+  Time GetCumulativeStateTime (State state) const;
   /**
    * \return the predicted delay until this PHY can become WifiPhy::IDLE.
    *
@@ -1380,6 +1385,38 @@ public:
    * \return the CCA threshold in dBm
    */
   double GetCcaMode1Threshold (void) const;
+  /**
+   * Sets the BSS color of this PHY. 0 disables BSS color filtering.
+   *
+   * \param color the BSS color
+   */
+  void SetBssColor (uint8_t color);
+  /**
+   * Return the BSS color of this PHY.
+   *
+   * \return the BSS color (0 if unset)
+   */
+  uint8_t GetBssColor (void) const;
+  /**
+   * Sets the OBSS PD level (dBm). Inter-BSS PPDUs received below
+   * this level do not set the CCA BUSY state.
+   *
+   * \param level the OBSS PD level in dBm
+   */
+  void SetObssPdLevel (double level);
+  /**
+   * Return the OBSS PD level (dBm).
+   *
+   * \return the OBSS PD level in dBm
+   */
+  double GetObssPdLevel (void) const;
+  /**
+   * \param color the BSS color carried by a received PPDU
+   *
+   * \return true if both colors are set and differ, i.e. the PPDU
+   *         comes from an overlapping BSS
+   */
+  bool IsInterBss (uint8_t color) const;
   /**
    * Sets the RX loss (dB) in the Signal-to-Noise-Ratio due to non-idealities in the receiver.
    *
@@ -1948,6 +1985,8 @@ private:
 
   double m_edThresholdW;          //!< Energy detection threshold in watts
   double   m_ccaMode1ThresholdW;  //!< Clear channel assessment (CCA) threshold in watts
+  uint8_t  m_bssColor;            //!< BSS color, 0 if unset
+  double   m_obssPdLevelW;        //!< OBSS PD level in watts
   double   m_txGainDb;            //!< Transmission gain (dB)
   double   m_rxGainDb;            //!< Reception gain (dB)
   double   m_txPowerBaseDbm;      //!< Minimum transmission power (dBm)
@@ -21,6 +21,7 @@
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
 #include "ns3/energy-source.h"
 #include "wifi-radio-energy-model.h"
 #include "wifi-tx-current-model.h"
@@ -78,6 +79,20 @@ WifiRadioEnergyModel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&WifiRadioEnergyModel::m_txCurrentModel),
                    MakePointerChecker<WifiTxCurrentModel> ())
+    .AddAttribute ("LazyAccounting",
+                   "If true, do not listen to the PHY state transitions: integrate "
+                   "the energy from the state times of the PHY when it is queried "
+                   "and at the checkpoints.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&WifiRadioEnergyModel::m_lazyAccounting),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CheckpointInterval",
+                   "With lazy accounting, the interval between two updates of the "
+                   "energy source forced by the model. Zero means the energy is only "
+                   "integrated when the source updates itself or is queried.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&WifiRadioEnergyModel::m_checkpointInterval),
+                   MakeTimeChecker ())
     .AddTraceSource ("TotalEnergyConsumption",
                      "Total energy consumption of the radio device.",
                      MakeTraceSourceAccessor (&WifiRadioEnergyModel::m_totalEnergyConsumption),
@@ -95,6 +110,8 @@ WifiRadioEnergyModel::WifiRadioEnergyModel ()
   m_isSupersededChangeState = false;
   m_energyDepletionCallback.Nullify ();
   m_source = NULL;
+  m_lazyAccounting = false;
+  m_averageCurrentA = 0;
   // set callback for WifiPhy listener
   m_listener = new WifiRadioEnergyModelPhyListener;
   m_listener->SetChangeStateCallback (MakeCallback (&DeviceEnergyModel::ChangeState, this));
@@ -120,6 +137,13 @@ double
 WifiRadioEnergyModel::GetTotalEnergyConsumption (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_lazyAccounting && m_phy != 0)
+    {
+      double charge;
+      Time elapsed;
+      GetPendingCharge (&charge, &elapsed);
+      return m_totalEnergyConsumption + charge * m_source->GetSupplyVoltage ();
+    }
   return m_totalEnergyConsumption;
 }
 
@@ -352,6 +376,36 @@ WifiRadioEnergyModel::GetPhyListener (void)
   return m_listener;
 }
 
+void
+WifiRadioEnergyModel::SetPhy (const Ptr<WifiPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  NS_ASSERT (m_lazyAccounting);
+  NS_ASSERT (m_source != NULL);
+  m_phy = phy;
+  if (m_txCurrentModel)
+    {
+      m_txCurrentA = m_txCurrentModel->CalcTxCurrent (phy->GetTxPowerStart ());
+    }
+  for (uint32_t i = 0; i <= WifiPhy::SLEEP; i++)
+    {
+      m_checkpointStateTime[i] = phy->GetCumulativeStateTime ((WifiPhy::State) i);
+    }
+  m_lastUpdateTime = Simulator::Now ();
+  m_averageCurrentA = m_idleCurrentA;
+  m_checkpointEvent.Cancel ();
+  if (m_checkpointInterval.IsStrictlyPositive ())
+    {
+      m_checkpointEvent = Simulator::Schedule (m_checkpointInterval, &WifiRadioEnergyModel::Checkpoint, this);
+    }
+}
+
+bool
+WifiRadioEnergyModel::IsLazyAccounting (void) const
+{
+  return m_lazyAccounting;
+}
+
 /*
  * Private functions start here.
  */
@@ -360,6 +414,8 @@ void
 WifiRadioEnergyModel::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  m_checkpointEvent.Cancel ();
+  m_phy = 0;
   m_source = NULL;
   m_energyDepletionCallback.Nullify ();
 }
@@ -368,6 +424,13 @@ double
 WifiRadioEnergyModel::DoGetCurrentA (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_lazyAccounting && m_phy != 0)
+    {
+      //the source reads the current on each of its updates to charge the
+      //interval since its previous update, which is the interval settled here
+      const_cast<WifiRadioEnergyModel *> (this)->SettleEnergy ();
+      return m_averageCurrentA;
+    }
   switch (m_currentState)
     {
     case WifiPhy::IDLE:
@@ -418,6 +481,60 @@ WifiRadioEnergyModel::SetWifiRadioState (const WifiPhy::State state)
                 " at time = " << Simulator::Now ());
 }
 
+void
+WifiRadioEnergyModel::GetPendingCharge (double *charge, Time *elapsed) const
+{
+  double currents[WifiPhy::SLEEP + 1];
+  currents[WifiPhy::IDLE] = m_idleCurrentA;
+  currents[WifiPhy::CCA_BUSY] = m_ccaBusyCurrentA;
+  currents[WifiPhy::TX] = m_txCurrentA;
+  currents[WifiPhy::RX] = m_rxCurrentA;
+  currents[WifiPhy::SWITCHING] = m_switchingCurrentA;
+  currents[WifiPhy::SLEEP] = m_sleepCurrentA;
+  *charge = 0;
+  *elapsed = Seconds (0);
+  for (uint32_t i = 0; i <= WifiPhy::SLEEP; i++)
+    {
+      Time stateTime = m_phy->GetCumulativeStateTime ((WifiPhy::State) i) - m_checkpointStateTime[i];
+      *charge += stateTime.GetSeconds () * currents[i];
+      *elapsed += stateTime;
+    }
+}
+
+void
+WifiRadioEnergyModel::SettleEnergy (void)
+{
+  NS_LOG_FUNCTION (this);
+  double charge;
+  Time elapsed;
+  GetPendingCharge (&charge, &elapsed);
+  if (!elapsed.IsStrictlyPositive ())
+    {
+      return;
+    }
+  m_totalEnergyConsumption += charge * m_source->GetSupplyVoltage ();
+  for (uint32_t i = 0; i <= WifiPhy::SLEEP; i++)
+    {
+      m_checkpointStateTime[i] = m_phy->GetCumulativeStateTime ((WifiPhy::State) i);
+    }
+  m_averageCurrentA = charge / elapsed.GetSeconds ();
+  m_lastUpdateTime = Simulator::Now ();
+  NS_LOG_DEBUG ("WifiRadioEnergyModel:Total energy consumption is " <<
+                m_totalEnergyConsumption << "J, average current " << m_averageCurrentA << "A");
+}
+
+void
+WifiRadioEnergyModel::Checkpoint (void)
+{
+  NS_LOG_FUNCTION (this);
+  // the source settles the energy when it reads the current
+  m_source->UpdateEnergySource ();
+  if (m_checkpointInterval.IsStrictlyPositive ())
+    {
+      m_checkpointEvent = Simulator::Schedule (m_checkpointInterval, &WifiRadioEnergyModel::Checkpoint, this);
+    }
+}
+
 // -------------------------------------------------------------------------- //
 
 WifiRadioEnergyModelPhyListener::WifiRadioEnergyModelPhyListener ()
@@ -196,6 +196,15 @@ private:
  * The dependence of the power consumption in transmission mode on the nominal
  * transmit power can also be achieved through a wifi tx current model.
  *
+ * Lazy accounting: when the LazyAccounting attribute is set, the model does
+ * not listen to the PHY. It is attached to the PHY of the device (see SetPhy)
+ * and integrates the energy from the time the PHY has spent in each state
+ * (see WifiPhy::GetCumulativeStateTime) each time the energy source reads
+ * its current, i.e., on every update of the source (periodic, queried, or
+ * forced by the checkpoints set by CheckpointInterval). The source is given
+ * the average current since its previous update. The TX current is the one at
+ * the TxPowerStart of the PHY. Depletion is thus detected with the granularity
+ * of the source updates, in exchange for no callback per state transition.
  */
 class WifiRadioEnergyModel : public DeviceEnergyModel
 {
@@ -368,6 +377,19 @@ public:
    */
   WifiRadioEnergyModelPhyListener * GetPhyListener (void);
 
+  /**
+   * \param phy the PHY of the device
+   *
+   * Attach the model to <i>phy</i> when lazy accounting is used: the energy
+   * is integrated from the state times of <i>phy</i>, and the checkpoints,
+   * if any, start.
+   */
+  void SetPhy (const Ptr<WifiPhy> phy);
+  /**
+   * \return true if the model uses lazy accounting
+   */
+  bool IsLazyAccounting (void) const;
+
 
 private:
   void DoDispose (void);
@@ -387,6 +409,25 @@ private:
    */
   void SetWifiRadioState (const WifiPhy::State state);
 
+  /**
+   * \param charge the charge drawn since the last checkpoint, in Coulomb
+   * \param elapsed the time elapsed since the last checkpoint
+   *
+   * Integrate the currents over the state times of the PHY accumulated
+   * since the last checkpoint (lazy accounting only).
+   */
+  void GetPendingCharge (double *charge, Time *elapsed) const;
+  /**
+   * Add the energy consumed since the last checkpoint to the total and
+   * set the average current of that interval (lazy accounting only).
+   */
+  void SettleEnergy (void);
+  /**
+   * Update the energy source, which settles the energy consumed since the
+   * last checkpoint (lazy accounting only).
+   */
+  void Checkpoint (void);
+
   Ptr<EnergySource> m_source; ///< energy source
 
   // Member variables for current draw in different radio modes.
@@ -416,6 +457,13 @@ private:
 
   /// WifiPhy listener
   WifiRadioEnergyModelPhyListener *m_listener;
+
+  bool m_lazyAccounting;       ///< integrate the state times of the PHY instead of listening to it
+  Time m_checkpointInterval;   ///< interval between two checkpoints (lazy accounting)
+  Ptr<WifiPhy> m_phy;          ///< PHY the energy is integrated from (lazy accounting)
+  Time m_checkpointStateTime[WifiPhy::SLEEP + 1]; ///< state times of m_phy at the last checkpoint
+  double m_averageCurrentA;    ///< average current over the last settled interval
+  EventId m_checkpointEvent;   ///< next checkpoint
 };
 
 } // namespace ns3
@@ -37,6 +37,69 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("WifiRemoteStationManager");
 
+namespace {
+
+/// Number of WifiRemoteStationState in each state slab
+const uint32_t STATE_SLAB_SIZE = 16;
+/// Granularity (in bytes) of the WifiRemoteStation size classes
+const std::size_t STATION_SIZE_CLASS = 16;
+/// Number of WifiRemoteStation size classes; larger stations use the global heap
+const std::size_t STATION_N_SIZE_CLASSES = 32;
+/// Number of WifiRemoteStation carved out of each station slab
+const std::size_t STATION_SLAB_SIZE = 32;
+
+/**
+ * \param address the MAC address
+ * \return the 48-bit integer value of the address
+ */
+uint64_t
+GetAddressKey (Mac48Address address)
+{
+  uint8_t buffer[6];
+  address.CopyTo (buffer);
+  uint64_t key = 0;
+  for (uint8_t i = 0; i < 6; i++)
+    {
+      key = (key << 8) | buffer[i];
+    }
+  return key;
+}
+
+/**
+ * \param address the MAC address
+ * \param tid the TID
+ * \return the key of the (address, TID) pair
+ */
+uint64_t
+GetStationKey (Mac48Address address, uint8_t tid)
+{
+  return (GetAddressKey (address) << 8) | tid;
+}
+
+/// Memory of the WifiRemoteStation of all the managers
+struct StationPool
+{
+  std::vector<void *> freeLists[STATION_N_SIZE_CLASSES]; //!< free stations of each size class
+  std::vector<void *> slabs;                             //!< slabs the stations are carved out of
+  uint64_t nLive;                                        //!< number of stations in use
+};
+
+/**
+ * The pool is never destroyed, so that stations deleted late during
+ * program exit can still be returned to it. Its slabs are released as
+ * soon as no station is in use, i.e., once every manager was disposed.
+ *
+ * \return the pool of WifiRemoteStation memory
+ */
+StationPool &
+GetStationPool (void)
+{
+  static StationPool *pool = new StationPool ();
+  return *pool;
+}
+
+} //anonymous namespace
+
 /**
  * HighLatencyDataTxVectorTag class
  */
@@ -399,7 +462,8 @@ WifiRemoteStationManager::GetTypeId (void)
 }
 
 WifiRemoteStationManager::WifiRemoteStationManager ()
-  : m_qosSupported (false),
+  : m_stateSlabUsed (0),
+    m_qosSupported (false),
     m_htSupported (false),
     m_vhtSupported (false),
     m_heSupported (false),
@@ -419,16 +483,13 @@ WifiRemoteStationManager::~WifiRemoteStationManager ()
 void
 WifiRemoteStationManager::DoDispose (void)
 {
-  for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
-    {
-      delete (*i);
-    }
-  m_states.clear ();
   for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
     {
       delete (*i);
     }
   m_stations.clear ();
+  m_stationIndex.Clear ();
+  DeleteStates ();
 }
 
 void
@@ -1648,15 +1709,14 @@ WifiRemoteStationState *
 WifiRemoteStationManager::LookupState (Mac48Address address) const
 {
   NS_LOG_FUNCTION (this << address);
-  for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+  uint64_t key = GetAddressKey (address);
+  WifiRemoteStationState *state = m_stateIndex.Find (key);
+  if (state != 0)
     {
-      if ((*i)->m_address == address)
-        {
-          NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
-          return (*i);
-        }
+      NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
+      return state;
     }
-  WifiRemoteStationState *state = new WifiRemoteStationState ();
+  state = const_cast<WifiRemoteStationManager *> (this)->AllocateState ();
   state->m_state = WifiRemoteStationState::BRAND_NEW;
   state->m_address = address;
   state->m_operationalRateSet.push_back (GetDefaultMode ());
@@ -1673,7 +1733,7 @@ WifiRemoteStationManager::LookupState (Mac48Address address) const
   state->m_htSupported = false;
   state->m_vhtSupported = false;
   state->m_heSupported = false;
-  const_cast<WifiRemoteStationManager *> (this)->m_states.push_back (state);
+  const_cast<WifiRemoteStationManager *> (this)->m_stateIndex.Insert (key, state);
   NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning new state");
   return state;
 }
@@ -1697,25 +1757,47 @@ WifiRemoteStation *
 WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
 {
   NS_LOG_FUNCTION (this << address << (uint16_t)tid);
-  for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+  uint64_t key = GetStationKey (address, tid);
+  WifiRemoteStation *station = m_stationIndex.Find (key);
+  if (station != 0)
     {
-      if ((*i)->m_tid == tid
-          && (*i)->m_state->m_address == address)
-        {
-          return (*i);
-        }
+      return station;
     }
   WifiRemoteStationState *state = LookupState (address);
 
-  WifiRemoteStation *station = DoCreateStation ();
+  station = DoCreateStation ();
   station->m_state = state;
   station->m_tid = tid;
   station->m_ssrc = 0;
   station->m_slrc = 0;
   const_cast<WifiRemoteStationManager *> (this)->m_stations.push_back (station);
+  const_cast<WifiRemoteStationManager *> (this)->m_stationIndex.Insert (key, station);
   return station;
 }
 
+WifiRemoteStationState *
+WifiRemoteStationManager::AllocateState (void)
+{
+  if (m_stateSlabs.empty () || m_stateSlabUsed == STATE_SLAB_SIZE)
+    {
+      m_stateSlabs.push_back (new WifiRemoteStationState[STATE_SLAB_SIZE]);
+      m_stateSlabUsed = 0;
+    }
+  return &m_stateSlabs.back ()[m_stateSlabUsed++];
+}
+
+void
+WifiRemoteStationManager::DeleteStates (void)
+{
+  for (std::vector<WifiRemoteStationState *>::const_iterator i = m_stateSlabs.begin (); i != m_stateSlabs.end (); i++)
+    {
+      delete [] (*i);
+    }
+  m_stateSlabs.clear ();
+  m_stateSlabUsed = 0;
+  m_stateIndex.Clear ();
+}
+
 void
 WifiRemoteStationManager::SetQosSupport (Mac48Address from, bool qosSupported)
 {
@@ -1821,6 +1903,7 @@ WifiRemoteStationManager::Reset (void)
       delete (*i);
     }
   m_stations.clear ();
+  m_stationIndex.Clear ();
   m_bssBasicRateSet.clear ();
   m_bssBasicRateSet.push_back (m_defaultTxMode);
   m_bssBasicMcsSet.clear ();
@@ -2213,6 +2296,74 @@ WifiRemoteStation::~WifiRemoteStation ()
   NS_LOG_FUNCTION (this);
 }
 
+void *
+WifiRemoteStation::operator new (std::size_t size)
+{
+  std::size_t sizeClass = (size + STATION_SIZE_CLASS - 1) / STATION_SIZE_CLASS;
+  if (sizeClass >= STATION_N_SIZE_CLASSES)
+    {
+      return ::operator new (size);
+    }
+  StationPool &pool = GetStationPool ();
+  std::vector<void *> &freeList = pool.freeLists[sizeClass];
+  if (freeList.empty ())
+    {
+      std::size_t objectSize = sizeClass * STATION_SIZE_CLASS;
+      uint8_t *slab = static_cast<uint8_t *> (::operator new (objectSize * STATION_SLAB_SIZE));
+      pool.slabs.push_back (slab);
+      for (std::size_t i = STATION_SLAB_SIZE; i > 0; i--)
+        {
+          freeList.push_back (slab + (i - 1) * objectSize);
+        }
+    }
+  void *p = freeList.back ();
+  freeList.pop_back ();
+  pool.nLive++;
+  return p;
+}
+
+void
+WifiRemoteStation::operator delete (void *p, std::size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  std::size_t sizeClass = (size + STATION_SIZE_CLASS - 1) / STATION_SIZE_CLASS;
+  if (sizeClass >= STATION_N_SIZE_CLASSES)
+    {
+      ::operator delete (p);
+      return;
+    }
+  StationPool &pool = GetStationPool ();
+  pool.freeLists[sizeClass].push_back (p);
+  NS_ASSERT (pool.nLive > 0);
+  if (--pool.nLive == 0)
+    {
+      for (std::size_t i = 0; i < STATION_N_SIZE_CLASSES; i++)
+        {
+          std::vector<void *> ().swap (pool.freeLists[i]);
+        }
+      for (std::vector<void *>::const_iterator i = pool.slabs.begin (); i != pool.slabs.end (); i++)
+        {
+          ::operator delete (*i);
+        }
+      std::vector<void *> ().swap (pool.slabs);
+    }
+}
+
+uint64_t
+WifiRemoteStation::GetNLive (void)
+{
+  return GetStationPool ().nLive;
+}
+
+uint64_t
+WifiRemoteStation::GetNSlabs (void)
+{
+  return GetStationPool ().slabs.size ();
+}
+
 WifiRemoteStationInfo::WifiRemoteStationInfo ()
   : m_memoryTime (Seconds (1.0)),
     m_lastUpdate (Seconds (0.0)),
@@ -30,6 +30,7 @@
 #include "ht-capabilities.h"
 #include "vht-capabilities.h"
 #include "he-capabilities.h"
+#include <vector>
 
 namespace ns3 {
 
@@ -77,6 +78,105 @@ private:
   double m_failAvg;
 };
 
+/**
+ * \ingroup wifi
+ * \brief open-addressing index of remote station objects
+ *
+ * Maps a 64-bit key built from a MAC address (and a TID) to a pointer,
+ * using linear probing over a power-of-two table. Only pointers are
+ * stored, so the indexed objects never move when the table grows.
+ */
+template <typename T>
+class WifiRemoteStationTable
+{
+public:
+  WifiRemoteStationTable ()
+    : m_size (0)
+  {
+  }
+  /**
+   * \param key the key
+   * \return the object stored for the key, or 0 if none
+   */
+  T * Find (uint64_t key) const
+  {
+    if (m_slots.empty ())
+      {
+        return 0;
+      }
+    uint32_t mask = m_slots.size () - 1;
+    for (uint32_t i = Hash (key) & mask; m_slots[i].value != 0; i = (i + 1) & mask)
+      {
+        if (m_slots[i].key == key)
+          {
+            return m_slots[i].value;
+          }
+      }
+    return 0;
+  }
+  /**
+   * \param key the key, which must not be in the table yet
+   * \param value the object to store
+   */
+  void Insert (uint64_t key, T *value)
+  {
+    if ((m_size + 1) * 2 > m_slots.size ())
+      {
+        Grow ();
+      }
+    uint32_t mask = m_slots.size () - 1;
+    uint32_t i = Hash (key) & mask;
+    while (m_slots[i].value != 0)
+      {
+        i = (i + 1) & mask;
+      }
+    m_slots[i].key = key;
+    m_slots[i].value = value;
+    m_size++;
+  }
+  /// Remove all the entries (the objects themselves are not deleted)
+  void Clear (void)
+  {
+    m_slots.clear ();
+    m_size = 0;
+  }
+
+private:
+  /// A slot of the table, empty when value is 0
+  struct Slot
+  {
+    uint64_t key; //!< the key
+    T *value;     //!< the stored object
+  };
+  /**
+   * \param key the key
+   * \return the Fibonacci hash of the key
+   */
+  static uint32_t Hash (uint64_t key)
+  {
+    return static_cast<uint32_t> ((key * 0x9e3779b97f4a7c15ULL) >> 32);
+  }
+  /// Double the number of slots and re-insert all the entries
+  void Grow (void)
+  {
+    std::vector<Slot> old;
+    old.swap (m_slots);
+    Slot empty = {0, 0};
+    m_slots.resize (old.empty () ? 16 : old.size () * 2, empty);
+    m_size = 0;
+    for (typename std::vector<Slot>::const_iterator i = old.begin (); i != old.end (); i++)
+      {
+        if (i->value != 0)
+          {
+            Insert (i->key, i->value);
+          }
+      }
+  }
+
+  std::vector<Slot> m_slots; //!< the slots
+  uint32_t m_size;           //!< the number of stored entries
+};
+
 /**
  * \ingroup wifi
  * \brief hold a list of per-remote-station state.
@@ -1452,9 +1552,13 @@ private:
    */
   typedef std::vector <WifiRemoteStation *> Stations;
   /**
-   * A vector of WifiRemoteStationStates
+   * Allocate a WifiRemoteStationState from the state slabs.
+   *
+   * \return a default-constructed WifiRemoteStationState
    */
-  typedef std::vector <WifiRemoteStationState *> StationStates;
+  WifiRemoteStationState* AllocateState (void);
+  /// Release all the state slabs
+  void DeleteStates (void);
 
   /**
    * This is a pointer to the WifiPhy associated with this
@@ -1485,8 +1589,11 @@ private:
   WifiModeList m_bssBasicRateSet; //!< basic rate set
   WifiModeList m_bssBasicMcsSet; //!< basic MCS set
 
-  StationStates m_states;  //!< States of known stations
+  std::vector<WifiRemoteStationState *> m_stateSlabs; //!< Blocks holding the states of known stations
+  uint32_t m_stateSlabUsed;                          //!< Number of states used in the last block
+  WifiRemoteStationTable<WifiRemoteStationState> m_stateIndex; //!< States of known stations, by address
   Stations m_stations;     //!< Information for each known stations
+  WifiRemoteStationTable<WifiRemoteStation> m_stationIndex; //!< Information for each known stations, by address and TID
 
   WifiMode m_defaultTxMode; //!< The default transmission mode
   WifiMode m_defaultTxMcs;   //!< The default transmission modulation-coding scheme (MCS)
@@ -1592,6 +1699,31 @@ struct WifiRemoteStationState
 struct WifiRemoteStation
 {
   virtual ~WifiRemoteStation ();
+  /**
+   * Stations of all rate control subclasses are carved out of slabs
+   * with one free list per size class, so that the stations dropped by
+   * WifiRemoteStationManager::Reset are recycled. The slabs are released
+   * when the last station in use is deleted.
+   *
+   * \param size the size of the most derived object
+   * \return the allocated memory
+   */
+  static void* operator new (std::size_t size);
+  /**
+   * Return a station to the free list of its size class.
+   *
+   * \param p the station memory
+   * \param size the size of the most derived object
+   */
+  static void operator delete (void *p, std::size_t size);
+  /**
+   * \return the number of stations in use, carved out of the slabs
+   */
+  static uint64_t GetNLive (void);
+  /**
+   * \return the number of slabs currently allocated
+   */
+  static uint64_t GetNSlabs (void);
   WifiRemoteStationState *m_state;  //!< Remote station state
   uint32_t m_ssrc;                  //!< STA short retry count
   uint32_t m_slrc;                  //!< STA long retry count
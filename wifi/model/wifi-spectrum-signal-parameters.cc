@@ -28,6 +28,9 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("WifiSpectrumSignalParameters");
 
 WifiSpectrumSignalParameters::WifiSpectrumSignalParameters ()
+  : ruBits (0),
+    muMode (false),
+    bssColor (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -37,6 +40,9 @@ WifiSpectrumSignalParameters::WifiSpectrumSignalParameters (const WifiSpectrumSi
 {
   NS_LOG_FUNCTION (this << &p);
   packet = p.packet;
+  ruBits = p.ruBits;
+  muMode = p.muMode;
+  bssColor = p.bssColor;
 }
 
 Ptr<SpectrumSignalParameters>
@@ -57,6 +57,11 @@ struct WifiSpectrumSignalParameters : public SpectrumSignalParameters
   uint32_t ruBits;
 
   bool muMode;
+
+  /**
+   * The BSS color of the transmitter (0 if unset)
+   */
+  uint8_t bssColor;
 };
 
 }  // namespace ns3
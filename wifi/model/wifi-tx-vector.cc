@@ -36,7 +36,8 @@ WifiTxVector::WifiTxVector ()
     m_modeInitialized (false),
     m_txPowerLevelInitialized (false),
     m_muMode (0),
-    m_ruBits (1)
+    m_ruBits (1),
+    m_bssColor (0)
 {
 }
 
@@ -63,7 +64,10 @@ WifiTxVector::WifiTxVector (WifiMode mode,
     m_aggregation (aggregation),
     m_stbc (stbc),
     m_modeInitialized (true),
-    m_txPowerLevelInitialized (true)
+    m_txPowerLevelInitialized (true),
+    m_muMode (0),
+    m_ruBits (1),
+    m_bssColor (0)
 {
 }
 
@@ -233,6 +237,18 @@ WifiTxVector::GetRuBits (void) const
   return m_ruBits;
 }
 
+void
+WifiTxVector::SetBssColor (uint8_t color)
+{
+  m_bssColor = color;
+}
+
+uint8_t
+WifiTxVector::GetBssColor (void) const
+{
+  return m_bssColor;
+}
+
 std::ostream & operator << ( std::ostream &os, const WifiTxVector &v)
 {
   os << "mode: " << v.GetMode () <<
@@ -245,7 +261,8 @@ std::ostream & operator << ( std::ostream &os, const WifiTxVector &v)
     " Nss: " << (uint16_t)v.GetNss () <<
     " Ness: " << (uint16_t)v.GetNess () <<
     " MPDU aggregation: " << v.IsAggregation () <<
-    " STBC: " << v.IsStbc ();
+    " STBC: " << v.IsStbc () <<
+    " BSS color: " << (uint16_t)v.GetBssColor ();
   return os;
 }
 
@@ -208,6 +208,16 @@ public:
 
   void SetMuMode (bool muMode);
   void SetRuBits (uint32_t ruBits);
+  /**
+   * Sets the BSS color of the transmitting BSS
+   *
+   * \param color the BSS color (0 if unset)
+   */
+  void SetBssColor (uint8_t color);
+  /**
+   * \returns the BSS color of the transmitting BSS (0 if unset)
+   */
+  uint8_t GetBssColor (void) const;
 
 
 private:
@@ -232,6 +242,7 @@ private:
   bool     m_txPowerLevelInitialized; /**< Internal initialization flag */
   bool 	   m_muMode;
   uint32_t m_ruBits; 
+  uint8_t  m_bssColor;           /**< BSS color, 0 if unset */
 };
 
 /**
@@ -22,6 +22,10 @@
 #include "ns3/log.h"
 #include "ns3/qos-utils.h"
 #include "ns3/ctrl-headers.h"
+#include "ns3/block-ack-cache.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/mac-low.h"
+#include "ns3/packet.h"
 
 using namespace ns3;
 
@@ -309,6 +313,221 @@ CtrlBAckResponseHeaderTest::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_blockAckHdr.IsPacketReceived (80), false, "error in compressed bitmap");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Test for the recipient block ack cache
+ */
+class BlockAckCacheTest : public TestCase
+{
+public:
+  BlockAckCacheTest ();
+private:
+  virtual void DoRun ();
+  /**
+   * Update the cache with an MPDU
+   * \param seq the sequence number of the MPDU
+   * \param fragment the fragment number of the MPDU
+   */
+  void Receive (uint16_t seq, uint8_t fragment);
+  BlockAckCache m_cache; ///< block ack cache
+};
+
+BlockAckCacheTest::BlockAckCacheTest ()
+  : TestCase ("Check the bitmap filled in by the block ack cache")
+{
+}
+
+void
+BlockAckCacheTest::Receive (uint16_t seq, uint8_t fragment)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetSequenceNumber (seq);
+  hdr.SetFragmentNumber (fragment);
+  m_cache.UpdateWithMpdu (&hdr);
+}
+
+void
+BlockAckCacheTest::DoRun (void)
+{
+  CtrlBAckResponseHeader blockAckHdr;
+  blockAckHdr.SetType (COMPRESSED_BLOCK_ACK);
+
+  //The window wraps around: 4080 ... 47
+  m_cache.Init (4080, 64);
+  for (uint16_t i = 4080; i != 20; i = (i + 1) % 4096)
+    {
+      Receive (i, 0);
+    }
+  Receive (30, 0);
+  Receive (30, 1);
+  blockAckHdr.SetStartingSequence (m_cache.GetWinStart ());
+  m_cache.FillBlockAckBitmap (&blockAckHdr);
+  NS_TEST_EXPECT_MSG_EQ (blockAckHdr.GetCompressedBitmap (), 0x000000fffffffffLL, "error in compressed bitmap");
+  NS_TEST_EXPECT_MSG_EQ (blockAckHdr.IsPacketReceived (30), false, "fragmented MSDU must not be reported");
+
+  //Receiving 100 moves the window to 37 ... 100: everything before 37 is forgotten
+  Receive (100, 0);
+  NS_TEST_EXPECT_MSG_EQ (m_cache.GetWinStart (), 37, "error in window start");
+  blockAckHdr.ResetBitmap ();
+  blockAckHdr.SetStartingSequence (m_cache.GetWinStart ());
+  m_cache.FillBlockAckBitmap (&blockAckHdr);
+  NS_TEST_EXPECT_MSG_EQ (blockAckHdr.GetCompressedBitmap (), 0x8000000000000000LL, "error in compressed bitmap");
+
+  //A block ack request moving the window past 100 clears the bitmap
+  m_cache.UpdateWithBlockAckReq (101);
+  blockAckHdr.ResetBitmap ();
+  blockAckHdr.SetStartingSequence (m_cache.GetWinStart ());
+  m_cache.FillBlockAckBitmap (&blockAckHdr);
+  NS_TEST_EXPECT_MSG_EQ (blockAckHdr.GetCompressedBitmap (), 0x0LL, "error in compressed bitmap");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Test for the recipient reorder buffer of MacLow
+ */
+class ReorderBufferTest : public TestCase
+{
+public:
+  ReorderBufferTest ();
+private:
+  virtual void DoRun ();
+  /**
+   * Buffer an MPDU
+   * \param seq the sequence number of the MPDU
+   * \param fragment the fragment number of the MPDU
+   * \param moreFragments whether more fragments of the MSDU follow
+   */
+  void Store (uint16_t seq, uint8_t fragment = 0, bool moreFragments = false);
+  /**
+   * Record an MPDU forwarded up
+   * \param packet the MPDU
+   * \param hdr the MAC header of the MPDU
+   */
+  void Receive (Ptr<Packet> packet, const WifiMacHeader *hdr);
+  /**
+   * Check the MPDUs forwarded up since the last check
+   * \param expected the expected sequence numbers, in order
+   * \param n the number of expected sequence numbers
+   */
+  void CheckReceived (const uint16_t *expected, uint32_t n);
+
+  MacLow::ReorderBuffer m_buffer; ///< reorder buffer
+  std::vector<uint16_t> m_received; ///< sequence numbers of the MPDUs forwarded up
+};
+
+ReorderBufferTest::ReorderBufferTest ()
+  : TestCase ("Check the MSDUs forwarded up by the reorder buffer")
+{
+}
+
+void
+ReorderBufferTest::Store (uint16_t seq, uint8_t fragment, bool moreFragments)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetSequenceNumber (seq);
+  hdr.SetFragmentNumber (fragment);
+  if (moreFragments)
+    {
+      hdr.SetMoreFragments ();
+    }
+  else
+    {
+      hdr.SetNoMoreFragments ();
+    }
+  m_buffer.Store (Create<Packet> (100), hdr);
+}
+
+void
+ReorderBufferTest::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
+{
+  m_received.push_back (hdr->GetSequenceNumber ());
+}
+
+void
+ReorderBufferTest::CheckReceived (const uint16_t *expected, uint32_t n)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_received.size (), n, "wrong number of MPDUs forwarded up");
+  for (uint32_t i = 0; i < n && i < m_received.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_received[i], expected[i], "wrong MPDU forwarded up at position " << i);
+    }
+  m_received.clear ();
+}
+
+void
+ReorderBufferTest::DoRun (void)
+{
+  MacLow::MacLowRxCallback rx = MakeCallback (&ReorderBufferTest::Receive, this);
+
+  //In order: each MSDU is forwarded as soon as it is received
+  Store (10);
+  NS_TEST_EXPECT_MSG_EQ (m_buffer.ForwardUntilFirstLost (10, rx), 11 << 4, "error in first lost");
+  Store (11);
+  NS_TEST_EXPECT_MSG_EQ (m_buffer.ForwardUntilFirstLost (11, rx), 12 << 4, "error in first lost");
+  uint16_t inOrder[] = {10, 11};
+  CheckReceived (inOrder, 2);
+
+  //Out of order: 13 and 14 wait for 12
+  Store (14);
+  Store (13);
+  NS_TEST_EXPECT_MSG_EQ (m_buffer.ForwardUntilFirstLost (12, rx), 12 << 4, "error in first lost");
+  CheckReceived (0, 0);
+  Store (12);
+  NS_TEST_EXPECT_MSG_EQ (m_buffer.ForwardUntilFirstLost (12, rx), 15 << 4, "error in first lost");
+  uint16_t outOfOrder[] = {12, 13, 14};
+  CheckReceived (outOfOrder, 3);
+
+  //Duplicates of a buffered MPDU are dropped
+  Store (16);
+  Store (16);
+  Store (15);
+  NS_TEST_EXPECT_MSG_EQ (m_buffer.ForwardUntilFirstLost (15, rx), 17 << 4, "error in first lost");
+  uint16_t duplicates[] = {15, 16};
+  CheckReceived (duplicates, 2);
+
+  //A block ack request with starting sequence 21, while 17 is missing and
+  //the MSDU 20 lacks its last fragment: 18 and 19 are forwarded, 20 is
+  //dropped, and 21 is forwarded once the window moved
+  Store (21);
+  Store (20, 0, true);
+  Store (19);
+  Store (18);
+  m_buffer.ForwardRange ((17 + 2048) % 4096, 21, rx);
+  uint16_t blockAckReq[] = {18, 19};
+  CheckReceived (blockAckReq, 2);
+  NS_TEST_EXPECT_MSG_EQ (m_buffer.ForwardUntilFirstLost (21, rx), 22 << 4, "error in first lost");
+  uint16_t afterBlockAckReq[] = {21};
+  CheckReceived (afterBlockAckReq, 1);
+  //the first fragment of 22 is buffered
+  Store (22, 0, true);
+  NS_TEST_EXPECT_MSG_EQ (m_buffer.ForwardUntilFirstLost (22, rx), (22 << 4) | 1, "error in first lost");
+  CheckReceived (0, 0);
+  Store (22, 1, false);
+  NS_TEST_EXPECT_MSG_EQ (m_buffer.ForwardUntilFirstLost (22, rx), 23 << 4, "error in first lost");
+  uint16_t fragments[] = {22, 22};
+  CheckReceived (fragments, 2);
+
+  //The sequence numbers wrap around at 4096
+  Store (0);
+  Store (4095);
+  Store (1);
+  Store (4094);
+  NS_TEST_EXPECT_MSG_EQ (m_buffer.ForwardUntilFirstLost (4094, rx), 2 << 4, "error in first lost");
+  uint16_t wrap[] = {4094, 4095, 0, 1};
+  CheckReceived (wrap, 4);
+  Store (3);
+  Store (4093);
+  m_buffer.ForwardRange ((4093 + 2048) % 4096, 4, rx);
+  uint16_t wrapRange[] = {4093, 3};
+  CheckReceived (wrapRange, 2);
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -327,6 +546,8 @@ BlockAckTestSuite::BlockAckTestSuite ()
   AddTestCase (new PacketBufferingCaseA, TestCase::QUICK);
   AddTestCase (new PacketBufferingCaseB, TestCase::QUICK);
   AddTestCase (new CtrlBAckResponseHeaderTest, TestCase::QUICK);
+  AddTestCase (new BlockAckCacheTest, TestCase::QUICK);
+  AddTestCase (new ReorderBufferTest, TestCase::QUICK);
 }
 
 static BlockAckTestSuite g_blockAckTestSuite; ///< the test suite
@@ -23,6 +23,7 @@
 #include "ns3/dcf-state.h"
 #include "ns3/dcf-manager.h"
 #include "ns3/dca-txop.h"
+#include "ns3/shared-medium-contention.h"
 
 using namespace ns3;
 
@@ -111,7 +112,11 @@ private:
 class DcfManagerTest : public TestCase
 {
 public:
-  DcfManagerTest ();
+  /**
+   * Constructor
+   * \param sharedContention whether the access timeouts go through a SharedMediumContention object
+   */
+  DcfManagerTest (bool sharedContention);
   virtual void DoRun (void);
 
   /**
@@ -268,6 +273,7 @@ private:
   DcfStates m_dcfStates; //!< the DCF states
   Dca m_dca; //!< the DCA
   uint32_t m_ackTimeoutValue; //!< the ack timeout value
+  bool m_sharedContention; //!< whether access timeouts go through a SharedMediumContention object
 };
 
 DcfStateTest::DcfStateTest (Ptr<DcaTxop> dca)
@@ -328,8 +334,9 @@ DcaTxopTest::NotifyWakeUp (void)
 {
 }
 
-DcfManagerTest::DcfManagerTest ()
-  : TestCase ("DcfManager")
+DcfManagerTest::DcfManagerTest (bool sharedContention)
+  : TestCase (sharedContention ? "DcfManager with shared medium contention" : "DcfManager"),
+    m_sharedContention (sharedContention)
 {
 }
 
@@ -420,6 +427,10 @@ void
 DcfManagerTest::StartTest (uint64_t slotTime, uint64_t sifs, uint64_t eifsNoDifsNoSifs, uint32_t ackTimeoutValue)
 {
   m_dcfManager = CreateObject<DcfManager> ();
+  if (m_sharedContention)
+    {
+      m_dcfManager->SetSharedMediumContention (CreateObject<SharedMediumContention> ());
+    }
   m_dcfManager->SetSlot (MicroSeconds (slotTime));
   m_dcfManager->SetSifs (MicroSeconds (sifs));
   m_dcfManager->SetEifsNoDifs (MicroSeconds (eifsNoDifsNoSifs + sifs));
@@ -911,6 +922,221 @@ DcfManagerTest::DoRun (void)
 }
 
 
+class DcfSharedContentionTest;
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Dca Txop of one of the stations of DcfSharedContentionTest
+ */
+class DcaTxopStationTest : public DcaTxop
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param test the test
+   * \param i the index of the station
+   */
+  DcaTxopStationTest (DcfSharedContentionTest *test, uint32_t i);
+
+
+private:
+  void NotifyAccessGranted (void);
+  void NotifyInternalCollision (void);
+  void NotifyCollision (void);
+  void DoDispose (void);
+
+  DcfSharedContentionTest *m_test; //!< the test
+  uint32_t m_i; //!< the index of the station
+};
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Several DcfManagers sharing one SharedMediumContention
+ *
+ * Stations with one DcfManager each hear each other's transmissions and
+ * draw their backoffs from fixed lists, some of them expiring at the same
+ * time. The access grants must happen at the same times and in the same
+ * order whether the managers schedule their own access timeouts or share
+ * one SharedMediumContention.
+ */
+class DcfSharedContentionTest : public TestCase
+{
+public:
+  DcfSharedContentionTest ();
+  virtual void DoRun (void);
+
+  /**
+   * Record the grant and transmit
+   * \param i the index of the station
+   */
+  void NotifyAccessGranted (uint32_t i);
+  /**
+   * Start the next backoff
+   * \param i the index of the station
+   */
+  void NotifyCollision (uint32_t i);
+
+
+private:
+  /// access grants: time and index of the station
+  typedef std::vector<std::pair<Time, uint32_t> > Grants;
+
+  /**
+   * Run the scenario
+   * \param sharedContention whether the managers share a SharedMediumContention
+   * \return the access grants
+   */
+  Grants RunScenario (bool sharedContention);
+  /**
+   * Request access, if the station has backoffs left
+   * \param i the index of the station
+   */
+  void RequestAccess (uint32_t i);
+
+  std::vector<Ptr<DcfManager> > m_managers; //!< the DCF manager of each station
+  std::vector<Ptr<DcfState> > m_states; //!< the DCF state of each station
+  std::vector<Ptr<DcaTxopStationTest> > m_dca; //!< the DCA of each station
+  std::vector<std::list<uint32_t> > m_backoffs; //!< the backoffs left to each station, in slots
+  Grants m_grants; //!< the access grants
+};
+
+DcaTxopStationTest::DcaTxopStationTest (DcfSharedContentionTest *test, uint32_t i)
+  : m_test (test),
+    m_i (i)
+{
+}
+
+void
+DcaTxopStationTest::DoDispose (void)
+{
+  m_test = 0;
+  DcaTxop::DoDispose ();
+}
+
+void
+DcaTxopStationTest::NotifyAccessGranted (void)
+{
+  m_test->NotifyAccessGranted (m_i);
+}
+
+void
+DcaTxopStationTest::NotifyInternalCollision (void)
+{
+  m_test->NotifyCollision (m_i);
+}
+
+void
+DcaTxopStationTest::NotifyCollision (void)
+{
+  m_test->NotifyCollision (m_i);
+}
+
+DcfSharedContentionTest::DcfSharedContentionTest ()
+  : TestCase ("DcfManagers sharing a SharedMediumContention grant access as separate ones")
+{
+}
+
+void
+DcfSharedContentionTest::NotifyAccessGranted (uint32_t i)
+{
+  m_grants.push_back (std::make_pair (Simulator::Now (), i));
+  Time txDuration = MicroSeconds (100);
+  for (uint32_t j = 0; j < m_managers.size (); j++)
+    {
+      if (j == i)
+        {
+          m_managers[j]->NotifyTxStartNow (txDuration);
+        }
+      else
+        {
+          m_managers[j]->NotifyRxStartNow (txDuration);
+          Simulator::Schedule (txDuration, &DcfManager::NotifyRxEndOkNow, m_managers[j]);
+        }
+    }
+  Simulator::Schedule (txDuration, &DcfSharedContentionTest::RequestAccess, this, i);
+}
+
+void
+DcfSharedContentionTest::NotifyCollision (uint32_t i)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_backoffs[i].empty (), false, "Station " << i << " has no backoff left");
+  m_states[i]->StartBackoffNow (m_backoffs[i].front ());
+  m_backoffs[i].pop_front ();
+}
+
+void
+DcfSharedContentionTest::RequestAccess (uint32_t i)
+{
+  if (!m_backoffs[i].empty ())
+    {
+      m_managers[i]->RequestAccess (m_states[i]);
+    }
+}
+
+DcfSharedContentionTest::Grants
+DcfSharedContentionTest::RunScenario (bool sharedContention)
+{
+  //stations 0 and 1, then 2 and 3, draw the same first backoff
+  uint32_t backoffs[][3] = {{3, 5, 2}, {3, 1, 4}, {6, 2, 7}, {6, 8, 1}};
+  uint32_t nStations = sizeof (backoffs) / sizeof (backoffs[0]);
+  Ptr<SharedMediumContention> contention = CreateObject<SharedMediumContention> ();
+  m_grants.clear ();
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      Ptr<DcfManager> manager = CreateObject<DcfManager> ();
+      if (sharedContention)
+        {
+          manager->SetSharedMediumContention (contention);
+        }
+      manager->SetSlot (MicroSeconds (9));
+      manager->SetSifs (MicroSeconds (16));
+      manager->SetEifsNoDifs (MicroSeconds (60));
+      Ptr<DcaTxopStationTest> dca = CreateObject<DcaTxopStationTest> (this, i);
+      Ptr<DcfState> state = CreateObject<DcfState> (dca);
+      state->SetAifsn (2);
+      manager->Add (state);
+      m_managers.push_back (manager);
+      m_states.push_back (state);
+      m_dca.push_back (dca);
+      m_backoffs.push_back (std::list<uint32_t> (backoffs[i], backoffs[i] + 3));
+      Simulator::Schedule (MicroSeconds (1), &DcfSharedContentionTest::RequestAccess, this, i);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_backoffs[i].empty (), true, "Station " << i << " did not use all its backoffs");
+      m_dca[i]->Dispose ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (contention->GetNPending (), 0, "Backoff expiries left pending");
+  m_managers.clear ();
+  m_states.clear ();
+  m_dca.clear ();
+  m_backoffs.clear ();
+  contention->Dispose ();
+  return m_grants;
+}
+
+void
+DcfSharedContentionTest::DoRun (void)
+{
+  Grants separate = RunScenario (false);
+  Grants shared = RunScenario (true);
+  NS_TEST_ASSERT_MSG_EQ (separate.size (), 12, "Every backoff must end with an access grant");
+  NS_TEST_ASSERT_MSG_EQ (shared.size (), separate.size (), "Different number of access grants");
+  for (uint32_t i = 0; i < separate.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (shared[i].first, separate[i].first, "Different time of access grant " << i);
+      NS_TEST_EXPECT_MSG_EQ (shared[i].second, separate[i].second, "Different station granted access " << i);
+    }
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -926,7 +1152,9 @@ public:
 DcfTestSuite::DcfTestSuite ()
   : TestSuite ("devices-wifi-dcf", UNIT)
 {
-  AddTestCase (new DcfManagerTest, TestCase::QUICK);
+  AddTestCase (new DcfManagerTest (false), TestCase::QUICK);
+  AddTestCase (new DcfManagerTest (true), TestCase::QUICK);
+  AddTestCase (new DcfSharedContentionTest, TestCase::QUICK);
 }
 
 static DcfTestSuite g_dcfTestSuite;
@@ -25,6 +25,7 @@
 #include "ns3/wifi-mac-trailer.h"
 #include "ns3/wifi-phy-tag.h"
 #include "ns3/wifi-spectrum-signal-parameters.h"
+#include "ns3/wifi-utils.h"
 
 using namespace ns3;
 
@@ -290,6 +291,78 @@ SpectrumWifiPhyListenerTest::DoRun (void)
   delete m_listener;
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Spectrum Wifi Phy BSS Color Test
+ */
+class SpectrumWifiPhyBssColorTest : public SpectrumWifiPhyBasicTest
+{
+public:
+  SpectrumWifiPhyBssColorTest ();
+  virtual ~SpectrumWifiPhyBssColorTest ();
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  /**
+   * Send a signal carrying a BSS color
+   * \param txPowerWatts the transmit power in watts
+   * \param color the BSS color of the transmitter
+   */
+  void SendColoredSignal (double txPowerWatts, uint8_t color);
+  TestPhyListener* m_listener; ///< listener
+};
+
+SpectrumWifiPhyBssColorTest::SpectrumWifiPhyBssColorTest ()
+  : SpectrumWifiPhyBasicTest ("SpectrumWifiPhy test BSS color filtering")
+{
+}
+
+SpectrumWifiPhyBssColorTest::~SpectrumWifiPhyBssColorTest ()
+{
+}
+
+void
+SpectrumWifiPhyBssColorTest::SendColoredSignal (double txPowerWatts, uint8_t color)
+{
+  Ptr<WifiSpectrumSignalParameters> params = DynamicCast<WifiSpectrumSignalParameters> (MakeSignal (txPowerWatts));
+  params->bssColor = color;
+  m_phy->StartRx (params);
+}
+
+void
+SpectrumWifiPhyBssColorTest::DoSetup (void)
+{
+  SpectrumWifiPhyBasicTest::DoSetup ();
+  m_phy->SetBssColor (1);
+  m_listener = new TestPhyListener;
+  m_phy->RegisterListener (m_listener);
+}
+
+// Intra-BSS and uncolored PPDUs are received, inter-BSS PPDUs are not
+// synchronized on and only set CCA BUSY above the OBSS PD level.
+void
+SpectrumWifiPhyBssColorTest::DoRun (void)
+{
+  double txPowerWatts = 0.010;
+  Simulator::Schedule (Seconds (1), &SpectrumWifiPhyBssColorTest::SendColoredSignal, this, txPowerWatts, 1);
+  Simulator::Schedule (Seconds (2), &SpectrumWifiPhyBssColorTest::SendColoredSignal, this, txPowerWatts, 0);
+  Simulator::Schedule (Seconds (3), &SpectrumWifiPhyBssColorTest::SendColoredSignal, this, txPowerWatts, 2);
+  // -90 dBm is below the default OBSS PD level of -82 dBm
+  Simulator::Schedule (Seconds (4), &SpectrumWifiPhyBssColorTest::SendColoredSignal, this, DbmToW (-90.0), 2);
+  // -70 dBm is above the OBSS PD level but below the default CCA Mode 1 threshold of -62 dBm
+  Simulator::Schedule (Seconds (5), &SpectrumWifiPhyBssColorTest::SendColoredSignal, this, DbmToW (-70.0), 2);
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_count, 2, "Didn't receive right number of packets");
+  NS_TEST_ASSERT_MSG_EQ (m_listener->m_notifyRxStart, 2, "Inter-BSS PPDU was synchronized on");
+  NS_TEST_ASSERT_MSG_EQ (m_listener->m_notifyMaybeCcaBusyStart, 2, "Inter-BSS PPDUs did not follow the OBSS PD level");
+
+  Simulator::Destroy ();
+  delete m_listener;
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -307,6 +380,7 @@ SpectrumWifiPhyTestSuite::SpectrumWifiPhyTestSuite ()
 {
   AddTestCase (new SpectrumWifiPhyBasicTest, TestCase::QUICK);
   AddTestCase (new SpectrumWifiPhyListenerTest, TestCase::QUICK);
+  AddTestCase (new SpectrumWifiPhyBssColorTest, TestCase::QUICK);
 }
 
 static SpectrumWifiPhyTestSuite spectrumWifiPhyTestSuite; ///< the test suite
@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Microbenchmarks of the wifi PHY primitives called for every frame:
+// WifiPhy::CalculateTxDuration for every mode of an 802.11ax 5 GHz PHY,
+// NistErrorRateModel::GetChunkSuccessRate, and the computation of the
+// SNR and PER of a frame by InterferenceHelper with N overlapping signals.
+//
+// One CSV line is printed per benchmark: its name, the number of
+// iterations of the measured batch and the wall-clock time per iteration.
+
+#include "ns3/command-line.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/interference-helper.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/microbenchmark.h"
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \param mode the payload mode
+ * \return the preamble of a 20 MHz frame sent with <i>mode</i>
+ */
+static WifiPreamble
+GetPreamble (WifiMode mode)
+{
+  switch (mode.GetModulationClass ())
+    {
+    case WIFI_MOD_CLASS_HT:
+      return WIFI_PREAMBLE_HT_MF;
+    case WIFI_MOD_CLASS_VHT:
+      return WIFI_PREAMBLE_VHT;
+    case WIFI_MOD_CLASS_HE:
+      return WIFI_PREAMBLE_HE_SU;
+    default:
+      return WIFI_PREAMBLE_LONG;
+    }
+}
+
+/**
+ * \param mode the payload mode
+ * \return the vector of a 20 MHz single stream frame sent with <i>mode</i>
+ */
+static WifiTxVector
+GetTxVector (WifiMode mode)
+{
+  return WifiTxVector (mode, 0, 0, GetPreamble (mode), 800, 1, 1, 0, 20, false, false);
+}
+
+int
+main (int argc, char *argv[])
+{
+  double minTime = 0.2; //seconds
+  std::string filter = "";
+
+  CommandLine cmd;
+  cmd.AddValue ("minTime", "Minimum duration of the measured batch of each benchmark in seconds", minTime);
+  cmd.AddValue ("filter", "Only run the benchmarks whose name contains this string", filter);
+  cmd.Parse (argc, argv);
+
+  const uint32_t size = 1500; //bytes
+  const uint16_t frequency = 5180;
+
+  Microbenchmark bench (std::cout, minTime, filter);
+  bench.PrintHeader ();
+
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ax_5GHZ);
+  std::vector<WifiMode> modes;
+  for (uint32_t i = 0; i < phy->GetNModes (); i++)
+    {
+      modes.push_back (phy->GetMode (i));
+    }
+  for (uint8_t i = 0; i < phy->GetNMcs (); i++)
+    {
+      modes.push_back (phy->GetMcs (i));
+    }
+  for (std::vector<WifiMode>::const_iterator i = modes.begin (); i != modes.end (); i++)
+    {
+      if (!i->IsAllowed (20, 1))
+        {
+          continue;
+        }
+      WifiTxVector txVector = GetTxVector (*i);
+      bench.Run ("WifiPhy/CalculateTxDuration/" + i->GetUniqueName (), [&] () {
+        Microbenchmark::DoNotOptimize (phy->CalculateTxDuration (size, txVector, frequency).GetDouble ());
+      });
+    }
+
+  Ptr<NistErrorRateModel> nist = CreateObject<NistErrorRateModel> ();
+  const double snr = 10; //linear, i.e., 10 dB
+  const uint32_t nbits = size * 8;
+  WifiMode chunkModes[] = {WifiPhy::GetOfdmRate6Mbps (), WifiPhy::GetOfdmRate54Mbps (),
+                           WifiPhy::GetHtMcs7 (), WifiPhy::GetHeMcs0 (), WifiPhy::GetHeMcs11 ()};
+  for (uint32_t i = 0; i < sizeof (chunkModes) / sizeof (chunkModes[0]); i++)
+    {
+      WifiMode mode = chunkModes[i];
+      WifiTxVector txVector = GetTxVector (mode);
+      bench.Run ("NistErrorRateModel/GetChunkSuccessRate/" + mode.GetUniqueName (), [&] () {
+        Microbenchmark::DoNotOptimize (nist->GetChunkSuccessRate (mode, txVector, snr, nbits));
+      });
+    }
+
+  //the signal and N - 1 interferers all start at time 0 and end at
+  //staggered times, so that the SNIR changes N times during the payload
+  uint32_t nSignals[] = {1, 10, 100};
+  for (uint32_t i = 0; i < sizeof (nSignals) / sizeof (nSignals[0]); i++)
+    {
+      InterferenceHelper interference;
+      interference.SetNoiseFigure (7.94); //9 dB
+      interference.SetErrorRateModel (nist);
+      WifiTxVector txVector = GetTxVector (WifiPhy::GetHeMcs7 ());
+      Time duration = phy->CalculateTxDuration (size, txVector, frequency);
+      Ptr<InterferenceHelper::Event> event = interference.Add (Create<Packet> (size), txVector, duration, 1e-9);
+      interference.NotifyRxStart ();
+      for (uint32_t j = 1; j < nSignals[i]; j++)
+        {
+          interference.Add (Create<Packet> (size), txVector, NanoSeconds (duration.GetNanoSeconds () * j / nSignals[i]), 1e-12);
+        }
+      std::ostringstream name;
+      name << "InterferenceHelper/CalculatePlcpPayloadSnrPer/" << nSignals[i];
+      bench.Run (name.str (), [&] () {
+        Microbenchmark::DoNotOptimize (interference.CalculatePlcpPayloadSnrPer (event).per);
+      });
+      interference.EraseEvents ();
+    }
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -37,6 +37,20 @@
 #include "ns3/packet-socket-server.h"
 #include "ns3/packet-socket-client.h"
 #include "ns3/packet-socket-helper.h"
+#include "ns3/mgt-headers.h"
+#include "ns3/wifi-mac-queue.h"
+#include "ns3/wifi-phy-state-helper.h"
+#include "ns3/wifi-device-counters.h"
+#include "ns3/wifi-latency-histogram.h"
+#include "ns3/constant-rate-wifi-manager.h"
+#include "ns3/he-ru-wifi-manager.h"
+#include "ns3/minstrel-ht-wifi-manager.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/basic-energy-source.h"
+#include "ns3/wifi-radio-energy-model.h"
+#include "ns3/uinteger.h"
+#include <cmath>
 
 using namespace ns3;
 
@@ -231,6 +245,618 @@ public:
 };
 
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief TF header User Info list serialization and lookup
+ */
+class MgtTFHeaderTest : public TestCase
+{
+public:
+  MgtTFHeaderTest () : TestCase ("MgtTFHeader User Info serialization and lookup")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    MgtTFHeader::RUAllocations alloc;
+    alloc.insert (std::make_pair (Mac48Address ("00:00:00:00:00:03"), 2));
+    alloc.insert (std::make_pair (Mac48Address ("00:00:00:00:00:01"), 0));
+    alloc.insert (std::make_pair (Mac48Address::GetBroadcast (), 8));
+    MgtTFHeader tf;
+    tf.SetRUAllocations (alloc);
+    tf.SetUplinkFlag (1);
+    tf.SetTfDuration (500);
+    NS_TEST_EXPECT_MSG_EQ (tf.GetSerializedSize (), MgtTFHeader::GetSizeForNoSta (3), "size must only depend on the number of STAs");
+
+    Ptr<Packet> packet = Create<Packet> ();
+    packet->AddHeader (tf);
+    MgtTFHeader rx;
+    packet->RemoveHeader (rx);
+    NS_TEST_EXPECT_MSG_EQ (rx.GetNoSta (), 3, "wrong number of User Info fields");
+    NS_TEST_EXPECT_MSG_EQ (rx.GetUplinkFlag (), 1, "wrong uplink flag");
+    NS_TEST_EXPECT_MSG_EQ (rx.GetTfDuration (), 500, "wrong TF duration");
+    uint32_t ru = 0;
+    NS_TEST_EXPECT_MSG_EQ (rx.GetUserInfo ().Lookup (Mac48Address ("00:00:00:00:00:03"), &ru), true, "STA 3 not found");
+    NS_TEST_EXPECT_MSG_EQ (ru, 2, "wrong RU for STA 3");
+    NS_TEST_EXPECT_MSG_EQ (rx.GetUserInfo ().Lookup (Mac48Address::GetBroadcast (), &ru), true, "random access RU not found");
+    NS_TEST_EXPECT_MSG_EQ (ru, 8, "wrong random access RU");
+    NS_TEST_EXPECT_MSG_EQ (rx.GetUserInfo ().Lookup (Mac48Address ("00:00:00:00:00:02"), &ru), false, "STA 2 has no RU");
+  }
+};
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Hash index and slab allocation of the remote stations
+ */
+class WifiRemoteStationIndexTest : public TestCase
+{
+public:
+  WifiRemoteStationIndexTest () : TestCase ("WifiRemoteStationManager station index and slabs")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    // 100 entries make the table grow from 16 to 256 slots
+    WifiRemoteStationTable<uint32_t> table;
+    std::vector<uint32_t> values (100);
+    for (uint32_t i = 0; i < values.size (); i++)
+      {
+        values[i] = i;
+        table.Insert ((static_cast<uint64_t> (i / 2) << 8) | (i % 2 == 0 ? 0 : 5), &values[i]);
+      }
+    for (uint32_t i = 0; i < values.size (); i++)
+      {
+        NS_TEST_EXPECT_MSG_EQ (table.Find ((static_cast<uint64_t> (i / 2) << 8) | (i % 2 == 0 ? 0 : 5)), &values[i], "entry " << i << " lost when growing");
+      }
+    NS_TEST_EXPECT_MSG_EQ (table.Find (static_cast<uint64_t> (1) << 8 | 6), 0, "TID 6 was never inserted");
+    table.Clear ();
+    NS_TEST_EXPECT_MSG_EQ (table.Find (0), 0, "entry found after Clear");
+
+    Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+    phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+    Ptr<WifiRemoteStationManager> manager = CreateObject<ConstantRateWifiManager> ();
+    manager->SetupPhy (phy);
+    manager->SetMaxSlrc (1);
+    uint64_t nLive = WifiRemoteStation::GetNLive ();
+    std::vector<Mac48Address> stas;
+    for (uint32_t i = 0; i < 40; i++)
+      {
+        stas.push_back (Mac48Address::Allocate ());
+        manager->RecordGotAssocTxOk (stas[i]);
+      }
+    // two cycles: the stations dropped by Reset are created again on the next lookup
+    for (uint32_t cycle = 0; cycle < 2; cycle++)
+      {
+        for (uint32_t i = 0; i < stas.size (); i += 2)
+          {
+            manager->ReportDataFailed (stas[i], &GetHeader (5));
+          }
+        for (uint32_t i = 0; i < stas.size (); i++)
+          {
+            NS_TEST_EXPECT_MSG_EQ (manager->IsAssociated (stas[i]), true, "STA " << i << " not associated in cycle " << cycle);
+            NS_TEST_EXPECT_MSG_EQ (manager->NeedDataRetransmission (stas[i], &GetHeader (5), Create<Packet> (100)), i % 2 == 1, "wrong TID 5 station of STA " << i << " in cycle " << cycle);
+            NS_TEST_EXPECT_MSG_EQ (manager->NeedDataRetransmission (stas[i], &GetHeader (0), Create<Packet> (100)), true, "wrong TID 0 station of STA " << i << " in cycle " << cycle);
+          }
+        NS_TEST_EXPECT_MSG_EQ (WifiRemoteStation::GetNLive (), nLive + 2 * stas.size (), "wrong number of stations in use in cycle " << cycle);
+        manager->Reset ();
+        NS_TEST_EXPECT_MSG_EQ (WifiRemoteStation::GetNLive (), nLive, "stations not freed by Reset in cycle " << cycle);
+      }
+    manager->Dispose ();
+    if (nLive == 0)
+      {
+        NS_TEST_EXPECT_MSG_EQ (WifiRemoteStation::GetNSlabs (), 0, "slabs not released with the last station");
+      }
+  }
+
+private:
+  /**
+   * \param tid the TID
+   * \return the header of a QoS data frame of the given TID
+   */
+  WifiMacHeader & GetHeader (uint8_t tid)
+  {
+    m_hdr.SetType (WIFI_MAC_QOSDATA);
+    m_hdr.SetQosTid (tid);
+    return m_hdr;
+  }
+
+  WifiMacHeader m_hdr; ///< the header of the data frames
+};
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief HE MCS selection of HeRuWifiManager from shared estimates
+ */
+class HeRuWifiManagerTest : public TestCase
+{
+public:
+  HeRuWifiManagerTest () : TestCase ("HeRuWifiManager shared estimates and MaxPer")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    Ptr<HeRuWifiManager> full = CreateManager ();
+    Ptr<HeRuWifiManager> ru = CreateManager ();
+    ru->ShareEstimates (full);
+    Ptr<HeRuWifiManager> alone = CreateManager ();
+    Mac48Address sta ("00:00:00:00:00:01");
+    WifiMacHeader hdr;
+    hdr.SetType (WIFI_MAC_QOSDATA);
+    hdr.SetQosTid (0);
+    Ptr<const Packet> packet = Create<Packet> (1000);
+    std::vector<Ptr<HeRuWifiManager> > managers;
+    managers.push_back (full);
+    managers.push_back (ru);
+    managers.push_back (alone);
+    for (uint32_t i = 0; i < managers.size (); i++)
+      {
+        managers[i]->AddStationHeCapabilities (sta, HeCapabilities ());
+      }
+
+    // an SNR of 30 dB, reported by the full channel manager only
+    for (uint32_t i = 0; i < 4; i++)
+      {
+        full->ReportDataOk (sta, &hdr, 1000, WifiPhy::GetOfdmRate6Mbps (), 1000);
+      }
+    WifiMode mode = full->GetDataTxVector (sta, &hdr, packet).GetMode ();
+    NS_TEST_EXPECT_MSG_EQ (mode.GetModulationClass (), WIFI_MOD_CLASS_HE, "not an HE MCS");
+    NS_TEST_EXPECT_MSG_GT (mode.GetMcsValue (), 0, "30 dB must allow more than HE MCS 0");
+    NS_TEST_EXPECT_MSG_EQ (ru->GetDataTxVector (sta, &hdr, packet).GetMode (), mode, "the RU manager does not use the shared estimate");
+    NS_TEST_EXPECT_MSG_EQ (alone->GetDataTxVector (sta, &hdr, packet).GetMode ().GetMcsValue (), 0, "a manager with its own estimates must know no SNR");
+
+    // MPDUs lost on the RU raise the shared PER above MaxPer
+    ru->ReportDataFailed (sta, &hdr);
+    NS_TEST_EXPECT_MSG_EQ (full->GetDataTxVector (sta, &hdr, packet).GetMode ().GetMcsValue (), mode.GetMcsValue () - 1, "MaxPer must step the MCS down once");
+    NS_TEST_EXPECT_MSG_EQ (ru->GetDataTxVector (sta, &hdr, packet).GetMode ().GetMcsValue (), mode.GetMcsValue () - 1, "MaxPer must step the MCS down on the RU too");
+
+    for (uint32_t i = 0; i < managers.size (); i++)
+      {
+        managers[i]->Dispose ();
+      }
+  }
+
+private:
+  /**
+   * \return a manager of an 802.11ax 5 GHz PHY, initialized
+   */
+  Ptr<HeRuWifiManager> CreateManager (void)
+  {
+    Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+    phy->SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+    phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ax_5GHZ);
+    Ptr<HeRuWifiManager> manager = CreateObject<HeRuWifiManager> ();
+    manager->SetHeSupported (true);
+    manager->SetupPhy (phy);
+    manager->Initialize ();
+    return manager;
+  }
+};
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Rate chosen by the fast mode of MinstrelHtWifiManager
+ */
+class MinstrelHtFastModeTest : public TestCase
+{
+public:
+  MinstrelHtFastModeTest () : TestCase ("MinstrelHt fast mode converges to the fastest rate allowed by the SNR"),
+                              m_sta ("00:00:00:00:00:01")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    m_phy = CreateObject<YansWifiPhy> ();
+    m_phy->SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+    m_phy->ConfigureStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+    m_manager = CreateObject<MinstrelHtWifiManager> ();
+    m_manager->SetAttribute ("FastModeRates", UintegerValue (2));
+    m_manager->SetHtSupported (true);
+    m_manager->SetupPhy (m_phy);
+    m_manager->Initialize ();
+    HtCapabilities htCapabilities;
+    htCapabilities.SetHtSupported (1);
+    for (uint8_t i = 0; i < 8; i++)
+      {
+        htCapabilities.SetRxMcsBitmask (i);
+        m_manager->AddSupportedMcs (m_sta, m_phy->GetMcs (i));
+      }
+    m_manager->AddStationHtCapabilities (m_sta, htCapabilities);
+    m_hdr.SetType (WIFI_MAC_QOSDATA);
+    m_hdr.SetQosTid (0);
+
+    //an SNR between the thresholds of MCS 4 and 5, then above the one of MCS 7
+    double lowSnr = std::sqrt (GetThreshold (4) * GetThreshold (5));
+    double highSnr = 2 * GetThreshold (7);
+    for (uint32_t i = 0; i < 80; i++)
+      {
+        Simulator::Schedule (MilliSeconds (5 * i + 1), &MinstrelHtFastModeTest::SendOk, this, lowSnr);
+        Simulator::Schedule (MilliSeconds (5 * i + 401), &MinstrelHtFastModeTest::SendOk, this, highSnr);
+      }
+    Simulator::Schedule (MilliSeconds (400), &MinstrelHtFastModeTest::Check, this, GetFastestMcs (lowSnr));
+    Simulator::Schedule (MilliSeconds (800), &MinstrelHtFastModeTest::Check, this, GetFastestMcs (highSnr));
+    Simulator::Run ();
+    Simulator::Destroy ();
+    NS_TEST_EXPECT_MSG_EQ (GetFastestMcs (lowSnr), 4, "wrong threshold ordering");
+    m_manager->Dispose ();
+    m_phy->Dispose ();
+  }
+
+private:
+  /**
+   * \param mcs the HT MCS
+   * \return the SNR at which <i>mcs</i> reaches the BER of the fast mode
+   */
+  double GetThreshold (uint8_t mcs)
+  {
+    WifiTxVector txVector;
+    txVector.SetNss (1);
+    txVector.SetGuardInterval (800);
+    txVector.SetChannelWidth (20);
+    txVector.SetMode (m_phy->GetMcs (mcs));
+    DoubleValue ber;
+    m_manager->GetAttribute ("FastModeBerThreshold", ber);
+    return m_phy->CalculateSnr (txVector, ber.Get ());
+  }
+  /**
+   * \param snr the SNR
+   * \return the fastest single stream HT MCS whose threshold is below <i>snr</i>
+   */
+  uint8_t GetFastestMcs (double snr)
+  {
+    uint8_t fastest = 0;
+    for (uint8_t i = 0; i < 8; i++)
+      {
+        if (GetThreshold (i) <= snr)
+          {
+            fastest = i;
+          }
+      }
+    return fastest;
+  }
+  /**
+   * Send a frame at the rate chosen by the manager and report its success
+   *
+   * \param snr the SNR of the frame
+   */
+  void SendOk (double snr)
+  {
+    m_manager->GetDataTxVector (m_sta, &m_hdr, Create<Packet> (1000));
+    m_manager->ReportDataOk (m_sta, &m_hdr, snr, WifiPhy::GetOfdmRate6Mbps (), snr);
+  }
+  /**
+   * \param mcs the expected MCS
+   */
+  void Check (uint8_t mcs)
+  {
+    WifiMode mode = m_manager->GetDataTxVector (m_sta, &m_hdr, Create<Packet> (1000)).GetMode ();
+    NS_TEST_EXPECT_MSG_EQ (mode, m_phy->GetMcs (mcs), "not the fastest rate allowed by the SNR at " << Simulator::Now ().GetMilliSeconds () << " ms");
+  }
+
+  Ptr<YansWifiPhy> m_phy; //!< the PHY
+  Ptr<MinstrelHtWifiManager> m_manager; //!< the manager under test
+  Mac48Address m_sta; //!< the remote station
+  WifiMacHeader m_hdr; //!< the header of the data frames
+};
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief WifiMacQueue per-(TID, address) lookups
+ */
+class WifiMacQueueFlowTest : public TestCase
+{
+public:
+  WifiMacQueueFlowTest () : TestCase ("WifiMacQueue per-(TID, address) lookups")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    Ptr<WifiMacQueue> queue = CreateObject<WifiMacQueue> ();
+    Mac48Address sta1 ("00:00:00:00:00:01");
+    Mac48Address sta2 ("00:00:00:00:00:02");
+    std::vector<Ptr<const Packet> > packets;
+    for (uint32_t i = 0; i < 6; i++)
+      {
+        WifiMacHeader hdr;
+        hdr.SetType (WIFI_MAC_QOSDATA);
+        hdr.SetAddr1 (i % 2 == 0 ? sta1 : sta2);
+        hdr.SetQosTid (i % 3 == 0 ? 0 : 5);
+        Ptr<const Packet> packet = Create<Packet> (100 + i);
+        packets.push_back (packet);
+        queue->Enqueue (Create<WifiMacQueueItem> (packet, hdr));
+      }
+    // sta1: packets 0 (TID 0), 2 (TID 5), 4 (TID 5); sta2: 1 (TID 5), 3 (TID 0), 5 (TID 5)
+    NS_TEST_EXPECT_MSG_EQ (queue->GetNPacketsByTidAndAddress (5, WifiMacHeader::ADDR1, sta1), 2, "wrong count for sta1/TID 5");
+    NS_TEST_EXPECT_MSG_EQ (queue->GetNPacketsByTidAndAddress (0, WifiMacHeader::ADDR1, sta2), 1, "wrong count for sta2/TID 0");
+    NS_TEST_EXPECT_MSG_EQ (queue->PeekByTidAndAddress (5, WifiMacHeader::ADDR1, sta2)->GetPacket (), packets[1], "wrong head for sta2/TID 5");
+    NS_TEST_EXPECT_MSG_EQ (queue->DequeueByTidAndAddress (5, WifiMacHeader::ADDR1, sta1)->GetPacket (), packets[2], "wrong head for sta1/TID 5");
+    NS_TEST_EXPECT_MSG_EQ (queue->DequeueByAddress (WifiMacHeader::ADDR1, sta2)->GetPacket (), packets[1], "wrong head for sta2");
+
+    WifiMacHeader hdr;
+    hdr.SetType (WIFI_MAC_QOSDATA);
+    hdr.SetAddr1 (sta1);
+    hdr.SetQosTid (5);
+    Ptr<const Packet> retry = Create<Packet> (200);
+    queue->PushFront (Create<WifiMacQueueItem> (retry, hdr));
+    NS_TEST_EXPECT_MSG_EQ (queue->PeekByTidAndAddress (5, WifiMacHeader::ADDR1, sta1)->GetPacket (), retry, "pushed front packet must be the head of its flow");
+    NS_TEST_EXPECT_MSG_EQ (queue->Dequeue ()->GetPacket (), retry, "pushed front packet must be the head of the queue");
+    NS_TEST_EXPECT_MSG_EQ (queue->Dequeue ()->GetPacket (), packets[0], "wrong head of the queue");
+    NS_TEST_EXPECT_MSG_EQ (queue->GetNPacketsByTidAndAddress (5, WifiMacHeader::ADDR1, sta1), 1, "wrong count for sta1/TID 5");
+    NS_TEST_EXPECT_MSG_EQ (queue->Remove (packets[4]), true, "packet 4 not found");
+    NS_TEST_EXPECT_MSG_EQ (queue->PeekByTidAndAddress (5, WifiMacHeader::ADDR1, sta1), 0, "sta1/TID 5 must be empty");
+    NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 2, "wrong number of packets");
+  }
+};
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief WifiMacQueue expiry of the packets queued at the tail and at the front
+ */
+class WifiMacQueueExpiryTest : public TestCase
+{
+public:
+  WifiMacQueueExpiryTest () : TestCase ("WifiMacQueue expiry of stale packets")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    m_queue = CreateObject<WifiMacQueue> ();
+    m_queue->SetMaxDelay (MilliSeconds (10));
+    m_hdr.SetType (WIFI_MAC_QOSDATA);
+    m_hdr.SetAddr1 (Mac48Address ("00:00:00:00:00:01"));
+    m_hdr.SetQosTid (0);
+    // created at 0 ms, pushed to the front at 8 ms
+    Ptr<WifiMacQueueItem> retry = Create<WifiMacQueueItem> (Create<Packet> (100), m_hdr);
+    m_queue->Enqueue (Create<WifiMacQueueItem> (Create<Packet> (100), m_hdr));
+    Simulator::Schedule (MilliSeconds (5), &WifiMacQueueExpiryTest::Enqueue, this);
+    Simulator::Schedule (MilliSeconds (8), &WifiMacQueueExpiryTest::PushFront, this, retry);
+    Simulator::Schedule (MilliSeconds (9), &WifiMacQueueExpiryTest::Check, this, 3);
+    Simulator::Schedule (MilliSeconds (12), &WifiMacQueueExpiryTest::Check, this, 1);
+    Simulator::Schedule (MilliSeconds (16), &WifiMacQueueExpiryTest::Check, this, 0);
+    Simulator::Run ();
+    Simulator::Destroy ();
+  }
+
+private:
+  /// Enqueue a new packet at the tail
+  void Enqueue (void)
+  {
+    m_queue->Enqueue (Create<WifiMacQueueItem> (Create<Packet> (100), m_hdr));
+  }
+  /**
+   * Enqueue an item at the front
+   * \param item the item
+   */
+  void PushFront (Ptr<WifiMacQueueItem> item)
+  {
+    m_queue->PushFront (item);
+  }
+  /**
+   * Check the number of packets in the queue
+   * \param expected the expected number of packets
+   */
+  void Check (uint32_t expected)
+  {
+    NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPackets (), expected, "wrong number of packets at " << Simulator::Now ().GetMilliSeconds () << " ms");
+    NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, WifiMacHeader::ADDR1, m_hdr.GetAddr1 ()), expected, "wrong number of packets in the flow");
+  }
+
+  Ptr<WifiMacQueue> m_queue; ///< the queue
+  WifiMacHeader m_hdr;       ///< the header of the queued packets
+};
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Cumulative state times of WifiPhyStateHelper
+ */
+class WifiPhyStateTimeTest : public TestCase
+{
+public:
+  WifiPhyStateTimeTest () : TestCase ("WifiPhyStateHelper cumulative state times")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    m_state = CreateObject<WifiPhyStateHelper> ();
+    WifiTxVector txVector;
+    txVector.SetMode (WifiPhy::GetOfdmRate6Mbps ());
+    // IDLE [0, 1], CCA_BUSY [1, 3], IDLE [3, 5], TX [5, 6], IDLE from 6 ms
+    Simulator::Schedule (MilliSeconds (1), &WifiPhyStateHelper::SwitchMaybeToCcaBusy, m_state, MilliSeconds (2));
+    Simulator::Schedule (MilliSeconds (2), &WifiPhyStateTimeTest::Check, this, 1000, 1000, 0);
+    Simulator::Schedule (MilliSeconds (5), &WifiPhyStateHelper::SwitchToTx, m_state, MilliSeconds (1), Create<Packet> (100), 0.0, txVector);
+    Simulator::Schedule (MicroSeconds (5500), &WifiPhyStateTimeTest::Check, this, 3000, 2000, 500);
+    Simulator::Schedule (MilliSeconds (8), &WifiPhyStateTimeTest::Check, this, 5000, 2000, 1000);
+    Simulator::Run ();
+    Simulator::Destroy ();
+  }
+
+private:
+  /**
+   * Check the cumulative state times
+   * \param idle the expected IDLE time in microseconds
+   * \param ccaBusy the expected CCA_BUSY time in microseconds
+   * \param tx the expected TX time in microseconds
+   */
+  void Check (int64_t idle, int64_t ccaBusy, int64_t tx)
+  {
+    NS_TEST_EXPECT_MSG_EQ (m_state->GetCumulativeStateTime (WifiPhy::IDLE).GetMicroSeconds (), idle, "wrong IDLE time at " << Simulator::Now ().GetMicroSeconds () << " us");
+    NS_TEST_EXPECT_MSG_EQ (m_state->GetCumulativeStateTime (WifiPhy::CCA_BUSY).GetMicroSeconds (), ccaBusy, "wrong CCA_BUSY time at " << Simulator::Now ().GetMicroSeconds () << " us");
+    NS_TEST_EXPECT_MSG_EQ (m_state->GetCumulativeStateTime (WifiPhy::TX).GetMicroSeconds (), tx, "wrong TX time at " << Simulator::Now ().GetMicroSeconds () << " us");
+  }
+
+  Ptr<WifiPhyStateHelper> m_state; ///< the state helper
+};
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Energy drained by WifiRadioEnergyModel with and without lazy accounting
+ */
+class WifiRadioEnergyLazyAccountingTest : public TestCase
+{
+public:
+  WifiRadioEnergyLazyAccountingTest () : TestCase ("WifiRadioEnergyModel lazy accounting matches the PHY listener")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+    phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+
+    m_listenerSource = CreateObject<BasicEnergySource> ();
+    m_listenerModel = CreateObject<WifiRadioEnergyModel> ();
+    m_listenerModel->SetEnergySource (m_listenerSource);
+    m_listenerSource->AppendDeviceEnergyModel (m_listenerModel);
+    phy->RegisterListener (m_listenerModel->GetPhyListener ());
+
+    //no checkpoint: only the periodic updates of the source and the queries
+    m_lazySource = CreateObject<BasicEnergySource> ();
+    m_lazyModel = CreateObject<WifiRadioEnergyModel> ();
+    m_lazyModel->SetAttribute ("LazyAccounting", BooleanValue (true));
+    m_lazyModel->SetEnergySource (m_lazySource);
+    m_lazySource->AppendDeviceEnergyModel (m_lazyModel);
+    m_lazyModel->SetPhy (phy);
+
+    m_listenerSource->Initialize ();
+    m_lazySource->Initialize ();
+
+    // IDLE [0, 1.5], SLEEP [1.5, 3.2], IDLE [3.2, 4], SLEEP [4, 4.5], IDLE from 4.5 s
+    Simulator::Schedule (Seconds (1.5), &WifiPhy::SetSleepMode, phy);
+    Simulator::Schedule (Seconds (2.5), &WifiRadioEnergyLazyAccountingTest::Check, this, Seconds (1.5), Seconds (1));
+    Simulator::Schedule (Seconds (3.2), &WifiPhy::ResumeFromSleep, phy);
+    Simulator::Schedule (Seconds (4), &WifiPhy::SetSleepMode, phy);
+    Simulator::Schedule (Seconds (4.5), &WifiPhy::ResumeFromSleep, phy);
+    Simulator::Schedule (Seconds (6.3), &WifiRadioEnergyLazyAccountingTest::Check, this, Seconds (4.1), Seconds (2.2));
+    Simulator::Stop (Seconds (7));
+    Simulator::Run ();
+    Simulator::Destroy ();
+  }
+
+private:
+  /**
+   * Check the energy drained from both sources
+   * \param idle the expected IDLE time
+   * \param sleep the expected SLEEP time
+   */
+  void Check (Time idle, Time sleep)
+  {
+    double expected = m_listenerSource->GetSupplyVoltage ()
+      * (idle.GetSeconds () * m_listenerModel->GetIdleCurrentA () + sleep.GetSeconds () * m_listenerModel->GetSleepCurrentA ());
+    NS_TEST_EXPECT_MSG_EQ_TOL (m_listenerSource->GetInitialEnergy () - m_listenerSource->GetRemainingEnergy (), expected, 1e-9,
+                               "wrong energy drained with the listener at " << Simulator::Now ().GetSeconds () << " s");
+    NS_TEST_EXPECT_MSG_EQ_TOL (m_lazySource->GetInitialEnergy () - m_lazySource->GetRemainingEnergy (), expected, 1e-9,
+                               "wrong energy drained with lazy accounting at " << Simulator::Now ().GetSeconds () << " s");
+    NS_TEST_EXPECT_MSG_EQ_TOL (m_lazyModel->GetTotalEnergyConsumption (), expected, 1e-9,
+                               "wrong total consumption with lazy accounting at " << Simulator::Now ().GetSeconds () << " s");
+  }
+
+  Ptr<BasicEnergySource> m_listenerSource; ///< the source of the model listening to the PHY
+  Ptr<WifiRadioEnergyModel> m_listenerModel; ///< the model listening to the PHY
+  Ptr<BasicEnergySource> m_lazySource; ///< the source of the lazy model
+  Ptr<WifiRadioEnergyModel> m_lazyModel; ///< the lazy model
+};
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Per-RU and per-AC accounting of WifiDeviceCounters
+ */
+class WifiDeviceCountersTest : public TestCase
+{
+public:
+  WifiDeviceCountersTest () : TestCase ("WifiDeviceCounters per-RU and per-AC accounting")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    WifiDeviceCounters counters;
+    WifiMacHeader hdr;
+    hdr.SetType (WIFI_MAC_QOSDATA);
+    hdr.SetQosTid (6);
+    counters.NotifyTxMpdu (3, hdr, 100);
+    hdr.SetRetry ();
+    counters.NotifyTxMpdu (3, hdr, 100);
+    hdr.SetType (WIFI_MAC_DATA);
+    counters.NotifyRxMpdu (WifiDeviceCounters::FULL_CHANNEL, hdr, 50);
+    counters.NotifyAmpdu (2);
+    counters.NotifyAmpdu (5);
+
+    NS_TEST_EXPECT_MSG_EQ (counters.txMpdus[3][AC_VO], 2, "wrong number of AC_VO MPDUs on RU 3");
+    NS_TEST_EXPECT_MSG_EQ (counters.txBytes[3][AC_VO], 200, "wrong number of AC_VO bytes on RU 3");
+    NS_TEST_EXPECT_MSG_EQ (counters.txRetries, 1, "wrong number of retries");
+    NS_TEST_EXPECT_MSG_EQ (counters.rxMpdus[WifiDeviceCounters::FULL_CHANNEL][AC_BE_NQOS], 1, "non-QoS data not counted under AC_BE_NQOS");
+    NS_TEST_EXPECT_MSG_EQ (counters.GetTotalTxMpdus (), 2, "wrong total of transmitted MPDUs");
+    NS_TEST_EXPECT_MSG_EQ (counters.GetTotalRxBytes (), 50, "wrong total of received bytes");
+    NS_TEST_EXPECT_MSG_EQ (counters.ampdus, 2, "wrong number of A-MPDUs");
+    NS_TEST_EXPECT_MSG_EQ (counters.ampduMpdus, 7, "wrong number of MPDUs in A-MPDUs");
+    NS_TEST_EXPECT_MSG_EQ (counters.maxAmpduMpdus, 5, "wrong largest A-MPDU");
+  }
+};
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief WifiLatencyHistogram buckets and percentiles, and WifiLatencyStats split
+ */
+class WifiLatencyHistogramTest : public TestCase
+{
+public:
+  WifiLatencyHistogramTest () : TestCase ("WifiLatencyHistogram buckets, percentiles and latency split")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    NS_TEST_EXPECT_MSG_EQ (WifiLatencyHistogram::GetBucket (NanoSeconds (500)), 0, "sub-microsecond latency not in the first bucket");
+    NS_TEST_EXPECT_MSG_EQ (WifiLatencyHistogram::GetBucket (MicroSeconds (1)), 1, "1 us not in the second bucket");
+    NS_TEST_EXPECT_MSG_EQ (WifiLatencyHistogram::GetBucket (MicroSeconds (2)), 1 + WifiLatencyHistogram::BUCKETS_PER_OCTAVE, "2 us not one octave above 1 us");
+    NS_TEST_EXPECT_MSG_EQ (WifiLatencyHistogram::GetBucket (Seconds (1000)), WifiLatencyHistogram::N_BUCKETS - 1, "large latency not in the last bucket");
+
+    WifiLatencyHistogram histogram;
+    for (uint32_t i = 0; i < 99; i++)
+      {
+        histogram.Add (MicroSeconds (10));
+      }
+    histogram.Add (MilliSeconds (10));
+    NS_TEST_EXPECT_MSG_EQ (histogram.GetCount (), 100, "wrong number of latencies");
+    NS_TEST_EXPECT_MSG_EQ (histogram.GetMean (), NanoSeconds (109900), "wrong mean");
+    NS_TEST_EXPECT_MSG_EQ (histogram.GetPercentile (50), histogram.GetPercentile (99), "p50 and p99 not in the same bucket");
+    NS_TEST_EXPECT_MSG_EQ ((histogram.GetPercentile (99) >= MicroSeconds (10)), true, "p99 below the bucket of 10 us");
+    NS_TEST_EXPECT_MSG_EQ ((histogram.GetPercentile (99) < MicroSeconds (12)), true, "p99 above the bucket of 10 us");
+    NS_TEST_EXPECT_MSG_EQ (histogram.GetPercentile (100), MilliSeconds (10), "p100 is not the max");
+
+    WifiLatencyStats stats;
+    Simulator::Schedule (MilliSeconds (10), &WifiLatencyStats::NotifyAcked, &stats,
+                         MilliSeconds (1), MilliSeconds (2), MilliSeconds (3), MilliSeconds (4));
+    //enqueued during the TXOP: no access latency
+    Simulator::Schedule (MilliSeconds (10), &WifiLatencyStats::NotifyAcked, &stats,
+                         MilliSeconds (5), MilliSeconds (2), MilliSeconds (3), MilliSeconds (8));
+    Simulator::Run ();
+    Simulator::Destroy ();
+
+    NS_TEST_EXPECT_MSG_EQ (stats.total.GetCount (), 2, "wrong number of MPDUs");
+    NS_TEST_EXPECT_MSG_EQ (stats.access.GetMax (), MilliSeconds (1), "wrong access latency");
+    NS_TEST_EXPECT_MSG_EQ (stats.access.GetBucketCount (0), 1, "access latency after the access request");
+    NS_TEST_EXPECT_MSG_EQ (stats.airTime.GetMax (), MilliSeconds (6), "wrong air time");
+    NS_TEST_EXPECT_MSG_EQ (stats.queueing.GetMax (), MilliSeconds (3), "wrong queueing latency");
+    NS_TEST_EXPECT_MSG_EQ (stats.total.GetMax (), MilliSeconds (9), "wrong total latency");
+  }
+};
+
 /**
  * See \bugid{991}
  */
@@ -1171,6 +1797,16 @@ WifiTestSuite::WifiTestSuite ()
 {
   AddTestCase (new WifiTest, TestCase::QUICK);
   AddTestCase (new QosUtilsIsOldPacketTest, TestCase::QUICK);
+  AddTestCase (new MgtTFHeaderTest, TestCase::QUICK);
+  AddTestCase (new WifiRemoteStationIndexTest, TestCase::QUICK);
+  AddTestCase (new HeRuWifiManagerTest, TestCase::QUICK);
+  AddTestCase (new MinstrelHtFastModeTest, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueFlowTest, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueExpiryTest, TestCase::QUICK);
+  AddTestCase (new WifiPhyStateTimeTest, TestCase::QUICK);
+  AddTestCase (new WifiRadioEnergyLazyAccountingTest, TestCase::QUICK);
+  AddTestCase (new WifiDeviceCountersTest, TestCase::QUICK);
+  AddTestCase (new WifiLatencyHistogramTest, TestCase::QUICK);
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); //Bug 991
   AddTestCase (new DcfImmediateAccessBroadcastTestCase, TestCase::QUICK);
   AddTestCase (new Bug730TestCase, TestCase::QUICK); //Bug 730